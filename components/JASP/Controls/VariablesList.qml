@@ -135,17 +135,7 @@ VariablesListBase
 
 	function selectShiftItems(selected)
 	{
-		var startIndex = variablesList.startShiftSelected;
-		var endIndex = variablesList.endShiftSelected;
-		if (startIndex > endIndex)
-		{
-			var temp = startIndex;
-			startIndex = endIndex;
-			endIndex = temp;
-		}
-
-		for (var i = startIndex; i <= endIndex; i++)
-			variablesList.model.selectItem(i, selected)
+		variablesList.model.selectRange(variablesList.startShiftSelected, variablesList.endShiftSelected, selected)
 	}
 
 	Text
@@ -1,6 +1,7 @@
 #include "altnavpostfixassignmentstrategy.h"
 #include "altnavscope.h"
 #include <cmath>
+#include <algorithm>
 #include "jaspcontrol.h"
 
 std::string capitalLetters = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
@@ -53,8 +54,27 @@ void PriorityStrategy::assignPostfixes(QList<ALTNavScope*>& children, QString pr
 			unassigned.push_back(scope);
 	}
 
-	//assign the leftover postfixes
+	//keep the postfix a scope already had if it is still free, so that adding or removing a scope does not change the tags of the others
 	std::string preferredSacrifices = "";
+	for (int i = unassigned.size() - 1; i >= 0; i--)
+	{
+		ALTNavScope* scope = unassigned[i];
+		QString current = scope->prefix();
+		if (current.length() != prefix.length() + 1 || !current.startsWith(prefix))
+			continue;
+
+		char option = current.back().toLatin1();
+		if (option >= 'A' && option <= 'Z' && !assigned.contains(option))
+		{
+			preferredSacrifices += option;
+			assigned.insert(option);
+			assignments[option - 'A'] = scope;
+			unassigned.removeAt(i);
+			scope->setPrefix(current); //its own children may still need their postfixes
+		}
+	}
+
+	//assign the leftover postfixes
 	for (char option : capitalLetters)
 	{
 		if(unassigned.empty())
@@ -78,6 +98,7 @@ void PriorityStrategy::assignPostfixes(QList<ALTNavScope*>& children, QString pr
 	//no spots left so we need a sacrifice. If no candidates is available we use Z. Who uses the letter Z anyways
 	if (assigned.size() == 26 && unassigned.size() > 0) //26 letters in alphabet
 	{
+		std::sort(preferredSacrifices.begin(), preferredSacrifices.end());
 		char sacrifice = preferredSacrifices.length() == 0 ? 'Z' : preferredSacrifices.back();
 		assigned.remove(sacrifice);
 		unassigned.push_back(assignments[sacrifice - 'A']);
@@ -0,0 +1,96 @@
+#include "altnavprefixtrie.h"
+
+void ALTNavPrefixTrie::clear()
+{
+	_nodes = { Node() };
+	_size = 0;
+	_collisions = 0;
+}
+
+int ALTNavPrefixTrie::_child(int node, QChar c) const
+{
+	for (int child : _nodes[node].children)
+		if (_nodes[child].character == c)
+			return child;
+
+	return NoNode;
+}
+
+void ALTNavPrefixTrie::insert(const QString& key, ALTNavScope* scope)
+{
+	int node = root();
+	bool collision = false;
+
+	for (QChar c : key)
+	{
+		//a shorter key is a prefix of this one
+		if (_nodes[node].scope)
+			collision = true;
+
+		int child = _child(node, c);
+		if (child == NoNode)
+		{
+			child = int(_nodes.size());
+			_nodes.push_back(Node());
+			_nodes.back().character = c;
+			_nodes[node].children.push_back(child);
+		}
+		node = child;
+	}
+
+	//same key (the first scope keeps it), or this key is a prefix of a longer one
+	if (_nodes[node].scope || !_nodes[node].children.empty())
+		collision = true;
+	if (!_nodes[node].scope)
+		_nodes[node].scope = scope;
+
+	_size++;
+	if (collision)
+		_collisions++;
+}
+
+int ALTNavPrefixTrie::walk(int node, QStringView key) const
+{
+	for (QChar c : key)
+	{
+		if (node == NoNode)
+			break;
+		node = _child(node, c);
+	}
+
+	return node;
+}
+
+void ALTNavPrefixTrie::collect(int node, QList<ALTNavScope*>& scopes, int skip) const
+{
+	if (node == NoNode || node == skip)
+		return;
+
+	if (_nodes[node].scope)
+		scopes.push_back(_nodes[node].scope);
+
+	for (int child : _nodes[node].children)
+		collect(child, scopes, skip);
+}
+
+QStringList ALTNavPrefixTrie::keys() const
+{
+	QStringList result;
+	QString key;
+	_keys(root(), key, result);
+
+	return result;
+}
+
+void ALTNavPrefixTrie::_keys(int node, QString& key, QStringList& keys) const
+{
+	if (_nodes[node].scope)
+		keys.push_back(key);
+
+	for (int child : _nodes[node].children)
+	{
+		key.push_back(_nodes[child].character);
+		_keys(child, key, keys);
+		key.chop(1);
+	}
+}
@@ -0,0 +1,58 @@
+#ifndef ALTNAVPREFIXTRIE_H
+#define ALTNAVPREFIXTRIE_H
+
+#include <QList>
+#include <QString>
+#include <QStringView>
+#include <vector>
+
+class ALTNavScope;
+
+/*!
+ * \brief Prefix trie of the prefixes of the children of an ALTNavScope.
+ *
+ * Built each time the postfixes of the children are assigned, so that each keystroke is resolved in O(input length) instead of comparing the input with every child.
+ * It also counts the collisions (a prefix that is the same as, or starts, another one): a postfix assignment strategy should never make any.
+ */
+class ALTNavPrefixTrie
+{
+public:
+	static const int NoNode = -1;
+
+	void clear();
+	void insert(const QString& key, ALTNavScope* scope);
+
+	int root() const { return 0; }
+	/*!
+	 * \brief Follows the characters of key from node
+	 * \return The node reached, or NoNode if no key starts with these characters
+	 */
+	int walk(int node, QStringView key) const;
+	ALTNavScope* scope(int node) const { return node >= 0 && node < int(_nodes.size()) ? _nodes[node].scope : nullptr; }
+	bool hasChildren(int node) const { return node >= 0 && node < int(_nodes.size()) && !_nodes[node].children.empty(); }
+	/*!
+	 * \brief Appends the scopes of the subtree of node, except those of the subtree of skip
+	 */
+	void collect(int node, QList<ALTNavScope*>& scopes, int skip = NoNode) const;
+
+	int size() const { return _size; }
+	int collisions() const { return _collisions; }
+	QStringList keys() const;
+
+private:
+	struct Node
+	{
+		QChar character;
+		ALTNavScope* scope = nullptr;
+		std::vector<int> children;
+	};
+
+	int _child(int node, QChar c) const;
+	void _keys(int node, QString& key, QStringList& keys) const;
+
+	std::vector<Node> _nodes = { Node() };
+	int _size = 0;
+	int _collisions = 0;
+};
+
+#endif // ALTNAVPREFIXTRIE_H
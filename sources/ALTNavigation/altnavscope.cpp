@@ -4,6 +4,9 @@
 
 #include <QQmlProperty>
 #include <QMetaObject>
+#include <QTimer>
+
+QMap<QQmlEngine*, QQmlComponent*> ALTNavScope::_tagComponentMap;
 
 ALTNavScope::ALTNavScope(QObject* attachee)
 	: QObject{attachee}
@@ -12,25 +15,51 @@ ALTNavScope::ALTNavScope(QObject* attachee)
 	if(attachee)
 	{
 		_attachee = qobject_cast<QQuickItem*>(attachee);
-		if(_attachee) //is a visual item
+		if(_attachee) //is a visual item, its tag is created when it gets active
 		{
-			//create a visual tag
-			QQmlComponent component(qmlEngine(_attachee), QUrl("qrc:///jasp-stats.org/imports/JASP/Controls/components/JASP/Controls/ALTNavTag.qml"), _attachee);
-			_attachedTag = qobject_cast<ALTNavTagBase*>(component.create());
-			if (_attachedTag)
-			{
-				_attachedTag->setParentItem(_attachee);
-				_attachedTag->setParent(_attachee);
-
-				//Find parent when attachee parent changes or component is completed (this is when registration of any parent is guaranteed)
-				QObject* attached_component = qmlAttachedPropertiesObject<QQmlComponent>(_attachee);
-				connect(attached_component, SIGNAL(completed()), this, SLOT(init()));
-				connect(_attachee, &QQuickItem::parentChanged, this, &ALTNavScope::registerWithParent);
-			}
+			//Find parent when attachee parent changes or component is completed (this is when registration of any parent is guaranteed)
+			QObject* attached_component = qmlAttachedPropertiesObject<QQmlComponent>(_attachee);
+			connect(attached_component, SIGNAL(completed()), this, SLOT(init()));
+			connect(_attachee, &QQuickItem::parentChanged, this, &ALTNavScope::registerWithParent);
 		}
 	}
 }
 
+QQmlComponent* ALTNavScope::getTagComponent(QQmlEngine* engine)
+{
+	if (!engine)
+		return nullptr;
+
+	QQmlComponent* result = _tagComponentMap[engine];
+	if (result == nullptr)
+	{
+		result = new QQmlComponent(engine, QUrl("qrc:///jasp-stats.org/imports/JASP/Controls/components/JASP/Controls/ALTNavTag.qml"), engine);
+		_tagComponentMap[engine] = result;
+	}
+
+	return result;
+}
+
+void ALTNavScope::createTag()
+{
+	if (_attachedTag || !_attachee || _scopeOnly)
+		return;
+
+	QQmlComponent* component = getTagComponent(qmlEngine(_attachee));
+	if (!component)
+		return;
+
+	_attachedTag = qobject_cast<ALTNavTagBase*>(component->create());
+	if (_attachedTag)
+	{
+		_attachedTag->setParentItem(_attachee);
+		_attachedTag->setParent(_attachee);
+		_attachedTag->setFullTag(_prefix);
+		if (_xSet)	_attachedTag->setX(_x);
+		if (_ySet)	_attachedTag->setY(_y);
+	}
+}
+
 ALTNavScope::~ALTNavScope()
 {
 	setParentScope(nullptr);
@@ -80,22 +109,43 @@ void ALTNavScope::registerWithParent()
 void ALTNavScope::addChild(ALTNavScope *child)
 {
 	_childScopes.push_back(child);
-	ALTNavControl* ctrl = ALTNavControl::ctrl();
-	if(ctrl->dynamicTreeUpdate())
-	{
-		ctrl->getCurrentNode()->setChildrenActive(ctrl->AltNavActive());
-		setChildrenPrefix();
-	}
+	_childrenTrieValid = false;
+	setChildrenPrefixDirty();
 }
 
 void ALTNavScope::removeChild(ALTNavScope *child)
 {
 	_childScopes.removeOne(child);
+	_childrenTrieValid = false;
+	setChildrenPrefixDirty();
+}
+
+void ALTNavScope::setChildrenPrefixDirty()
+{
+	_childrenPrefixDirty = true;
+
+	//setPrefix skips the clean subtrees: the ancestors must be dirty as well to reach this scope from the root
+	for (ALTNavScope* scope = _parentScope; scope && !scope->_childrenPrefixDirty; scope = scope->_parentScope)
+		scope->_childrenPrefixDirty = true;
+
+	//Adding many children (e.g. rows of a list) should not recompute all postfixes for each child
+	if(ALTNavControl::ctrl()->dynamicTreeUpdate() && !_childrenPrefixScheduled)
+	{
+		_childrenPrefixScheduled = true;
+		QTimer::singleShot(0, this, &ALTNavScope::updateChildrenPrefix);
+	}
+}
+
+void ALTNavScope::updateChildrenPrefix()
+{
+	_childrenPrefixScheduled = false;
+
 	ALTNavControl* ctrl = ALTNavControl::ctrl();
 	if(ctrl->dynamicTreeUpdate())
 	{
 		ctrl->getCurrentNode()->setChildrenActive(ctrl->AltNavActive());
-		setChildrenPrefix();
+		if (_childrenPrefixDirty)
+			setChildrenPrefix();
 	}
 }
 
@@ -120,35 +170,58 @@ void ALTNavScope::init()
 }
 
 
+const ALTNavPrefixTrie& ALTNavScope::childrenTrie()
+{
+	if (!_childrenTrieValid)
+	{
+		_childrenTrie.clear();
+		for(ALTNavScope* scope : qAsConst(_childScopes))
+			_childrenTrie.insert(scope->_prefix, scope);
+
+		_childrenTrieValid = true;
+		_lastTraverseNode = ALTNavPrefixTrie::NoNode;
+	}
+
+	return _childrenTrie;
+}
+
 void ALTNavScope::traverse(QString input)
 {
 	ALTNavControl* ctrl = ALTNavControl::ctrl();
+	const ALTNavPrefixTrie& trie = childrenTrie();
 
-	bool matchPossible = false;
-	for(ALTNavScope* scope : qAsConst(_childScopes))
+	int node = trie.walk(trie.root(), input);
+
+	//total match, progress in tree
+	ALTNavScope* scope = trie.scope(node);
+	if(scope)
 	{
-		//total match, progress in tree
-		if(scope->_prefix == input)
-		{
-			ctrl->setCurrentNode(scope);
-			scope->match();
-			scope->traverse(input);
-			return;
-		}
-		//partial match
-		bool partialMatch = input.length() < scope->_prefix.length() && scope->_prefix.first(input.length()) == input;
-		if (!partialMatch)
-			scope->setScopeActive(false);
-		matchPossible |= partialMatch;
+		_lastTraverseNode = ALTNavPrefixTrie::NoNode;
+		ctrl->setCurrentNode(scope);
+		scope->match();
+		scope->traverse(input);
+		return;
 	}
 
 	//end of the road so we disable the altnavigation mode and return to root
-	if(!matchPossible)
+	if(!trie.hasChildren(node))
 	{
+		_lastTraverseNode = ALTNavPrefixTrie::NoNode;
 		ctrl->setCurrentNode(ctrl->getCurrentRoot());
 		ctrl->setAltNavActive(false);
+		return;
 	}
 
+	//partial match: hide the children that do not match anymore.
+	//When the input just got longer, the ones that did not match the previous input are already hidden.
+	int from = _lastTraverseNode != ALTNavPrefixTrie::NoNode && input.startsWith(_lastTraverseInput) ? _lastTraverseNode : trie.root();
+	QList<ALTNavScope*> noMatch;
+	trie.collect(from, noMatch, node);
+	for(ALTNavScope* child : qAsConst(noMatch))
+		child->setScopeActive(false);
+
+	_lastTraverseInput = input;
+	_lastTraverseNode = node;
 }
 
 void ALTNavScope::match()
@@ -159,6 +232,10 @@ void ALTNavScope::match()
 
 void ALTNavScope::setPrefix(QString prefix)
 {
+	//Nothing changed for this subtree
+	if (prefix == _prefix && !_childrenPrefixDirty)
+		return;
+
 	_prefix = prefix;
 	if (_attachedTag)
 		_attachedTag->setFullTag(_prefix);
@@ -167,6 +244,8 @@ void ALTNavScope::setPrefix(QString prefix)
 
 void ALTNavScope::setChildrenPrefix()
 {
+	_childrenPrefixDirty = false;
+	_childrenTrieValid = false;
 	if(_postfixBroker)
 		_postfixBroker->assignPostfixes(_childScopes, _prefix);
 }
@@ -175,13 +254,19 @@ void ALTNavScope::setScopeActive(bool value)
 {
 	_scopeActive = value;
 	if (!_scopeOnly)
-		_attachedTag->setActive(value);
+	{
+		if (value)
+			createTag();
+		if (_attachedTag)
+			_attachedTag->setActive(value);
+	}
 	if (_propagateActivity)
 		setChildrenActive(value);
 }
 
 void ALTNavScope::setChildrenActive(bool value)
 {
+	_lastTraverseNode = ALTNavPrefixTrie::NoNode;
 	for(ALTNavScope* child : _childScopes)
 	{
 		child->setScopeActive(value);
@@ -233,13 +318,17 @@ void ALTNavScope::setRoot(bool value)
 void ALTNavScope::setX(qreal x)
 {
 	_x = x;
-	_attachedTag->setX(_x);
+	_xSet = true;
+	if (_attachedTag)
+		_attachedTag->setX(_x);
 }
 
 void ALTNavScope::setY(qreal y)
 {
 	_y = y;
-	_attachedTag->setY(_y);
+	_ySet = true;
+	if (_attachedTag)
+		_attachedTag->setY(_y);
 }
 
 QString ALTNavScope::getRequestedPostfix()
@@ -301,11 +390,15 @@ void ALTNavScope::setParentAttachee(QObject* parent)
 void ALTNavScope::setRequestedPostfix(QString postfix)
 {
 	_requestedPostfix = postfix;
+	if (_parentScope)
+		_parentScope->setChildrenPrefixDirty();
 }
 
 void ALTNavScope::setScopePriority(int priority)
 {
 	_scopePriority = priority;
+	if (_parentScope)
+		_parentScope->setChildrenPrefixDirty();
 }
 
 void ALTNavScope::setIndex(int index)
@@ -313,7 +406,7 @@ void ALTNavScope::setIndex(int index)
 	_index = index;
 	//indices changed recalc prefixes
 	if (_parentScope)
-		_parentScope->setChildrenPrefix();
+		_parentScope->setChildrenPrefixDirty();
 }
 
 void ALTNavScope::setStrategy(JASP::AssignmentStrategy strategy)
@@ -327,4 +420,5 @@ void ALTNavScope::setStrategy(ALTNavPostfixAssignmentStrategy* strategy)
 {
 	delete _postfixBroker;
 	_postfixBroker = strategy;
+	setChildrenPrefixDirty();
 }
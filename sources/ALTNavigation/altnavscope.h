@@ -3,9 +3,12 @@
 
 #include <QObject>
 #include <QQuickItem>
+#include <QQmlComponent>
+#include <QQmlEngine>
 
 #include "altnavtagbase.h"
 #include "altnavpostfixassignmentstrategy.h"
+#include "altnavprefixtrie.h"
 
 /*! \brief Attaching object type providing the properties and signals along with most of the tree construction and traversal logic.
  *
@@ -78,12 +81,20 @@ public:
 	 * \param prefix
 	 */
 	void setChildrenPrefix();
+	/*!
+	 * \brief Marks the postfixes of the children as outdated. They are recomputed once per event loop if the tree is dynamically updated, otherwise when the ALT mode is activated.
+	 */
+	void setChildrenPrefixDirty();
 	/*!
 	 * \brief Sets child scope activities.
 	 * \param value
 	 */
 	void setChildrenActive(bool value);
 	void match();
+	/*!
+	 * \brief Returns the prefix trie of the children, built again if they or their prefixes changed
+	 */
+	const ALTNavPrefixTrie& childrenTrie();
 
 	QString getRequestedPostfix();
 	int getScopePriority();
@@ -109,6 +120,13 @@ protected:
 	void setY(qreal y);
 
 
+private:
+	/*!
+	 * \brief Creates the visual ALTNavTag, only once the scope gets active for the first time: most scopes are never shown.
+	 */
+	void createTag();
+	static QQmlComponent* getTagComponent(QQmlEngine* engine);
+
 private slots:
 	void init();
 
@@ -118,6 +136,7 @@ private slots:
 	 */
 	void registerWithParent();
 
+	void updateChildrenPrefix();
 	void addChild(ALTNavScope* child);
 	void removeChild(ALTNavScope* child);
 	void setParentScope(ALTNavScope* parent);
@@ -138,13 +157,21 @@ private:
 	int _index = -1;
 	int _scopePriority = 0;
 	JASP::AssignmentStrategy _currentStrategy = JASP::AssignmentStrategy::PRIORITIZED;
-	qreal _x, _y;
+	qreal _x = 0, _y = 0;
+	bool _xSet = false, _ySet = false;
 
 	QQuickItem* _attachee;
 	ALTNavTagBase* _attachedTag = nullptr;
 	QQuickItem* _parentScopeAttachee = nullptr;
 	bool _parentOverride = false;
 	bool _initialized = false;
+	bool _childrenPrefixDirty = true;
+	bool _childrenPrefixScheduled = false;
+
+	ALTNavPrefixTrie _childrenTrie;
+	bool _childrenTrieValid = false;
+	QString _lastTraverseInput;
+	int _lastTraverseNode = ALTNavPrefixTrie::NoNode;
 
 	QList<ALTNavScope*> _childScopes;
 	ALTNavScope* _parentScope = nullptr;
@@ -152,6 +179,8 @@ private:
 
 	ALTNavPostfixAssignmentStrategy* _postfixBroker = nullptr;
 
+	static QMap<QQmlEngine*, QQmlComponent*> _tagComponentMap;
+
 	friend class ALTNavPostfixAssignmentStrategy;
 
 };
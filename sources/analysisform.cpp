@@ -26,13 +26,16 @@
 #include "log.h"
 #include "controls/jaspcontrol.h"
 #include "rsyntax/rsyntax.h"
+#include "variableinfocache.h"
 
 #include <QQmlProperty>
 #include <QQmlContext>
 #include <QQmlEngine>
 #include <QTimer>
-#include <QJsonDocument>
+#include <QMetaMethod>
 #include <QJsonObject>
+#include <algorithm>
+#include <iterator>
 #include "controls/variableslistbase.h"
 #include "preferencesmodelbase.h"
 
@@ -43,8 +46,11 @@ AnalysisForm::AnalysisForm(QQuickItem *parent) : AnalysisFormBase(parent)
 	setObjectName("AnalysisForm");
 
 	_rSyntax = new RSyntax(this);
+	_variableInfoCache = new VariableInfoCache(this);
+	_rScriptCache.setMaxCost(0);
 	// _startRSyntaxTimer is used to call setRSyntaxText only once in a event loop.
-	connect(this,									&AnalysisForm::infoChanged,					this, &AnalysisForm::helpMDChanged			);
+	connect(this,									&AnalysisForm::infoChanged,					this, &AnalysisForm::helpMDChangedHandler	);
+	connect(this,									&AnalysisForm::titleChanged,				this, &AnalysisForm::helpMDChangedHandler	);
 	connect(this,									&AnalysisForm::formCompletedSignal,			this, &AnalysisForm::formCompletedHandler,	Qt::QueuedConnection);
 	connect(this,									&AnalysisForm::analysisChanged,				this, &AnalysisForm::knownIssuesUpdated,	Qt::QueuedConnection);
 	connect(KnownIssues::issues(),					&KnownIssues::knownIssuesUpdated,			this, &AnalysisForm::knownIssuesUpdated,	Qt::QueuedConnection);
@@ -52,6 +58,17 @@ AnalysisForm::AnalysisForm(QQuickItem *parent) : AnalysisFormBase(parent)
 	connect(PreferencesModelBase::preferences(),	&PreferencesModelBase::showRSyntaxChanged,	this, &AnalysisForm::setRSyntaxText,		Qt::QueuedConnection);
 	connect(PreferencesModelBase::preferences(),	&PreferencesModelBase::showAllROptionsChanged,	this, &AnalysisForm::showAllROptionsChanged, Qt::QueuedConnection	);
 	connect(this,									&AnalysisForm::analysisChanged,				this, &AnalysisForm::setRSyntaxText,		Qt::QueuedConnection);
+
+	VariableInfo* variableInfo = VariableInfo::info();
+	if (variableInfo)
+	{
+		connect(variableInfo,						&VariableInfo::columnsChanged,				this, &AnalysisForm::dataSetChangedHandler	);
+		connect(variableInfo,						&VariableInfo::rowCountChanged,				this, &AnalysisForm::dataSetChangedHandler	);
+		connect(variableInfo,						&VariableInfo::namesChanged,				this, &AnalysisForm::dataSetChangedHandler	);
+		connect(variableInfo,						&VariableInfo::columnTypeChanged,			this, &AnalysisForm::dataSetChangedHandler	);
+		connect(variableInfo,						&VariableInfo::labelsChanged,				this, &AnalysisForm::dataSetChangedHandler	);
+		connect(variableInfo,						&VariableInfo::labelsReordered,				this, &AnalysisForm::dataSetChangedHandler	);
+	}
 }
 
 AnalysisForm::~AnalysisForm()
@@ -61,11 +78,95 @@ AnalysisForm::~AnalysisForm()
 
 void AnalysisForm::runRScript(QString script, QString controlName, bool whiteListedVersion)
 {
-	if(_analysis && !_removed)
+	if(!_analysis || _removed)
+		return;
+
+	RScriptRequest	request = { script, controlName, whiteListedVersion, qHashMulti(0, script, whiteListedVersion) };
+	bool			blocked = _valueChangedSignalsBlocked > 0;
+
+	// A request that will be sent supersedes the one of the same control waiting for the signals to be unblocked (which might never be sent)
+	if (!blocked)
+		for (int i = 0; i < _blockedRScripts.size(); i++)
+			if (_blockedRScripts[i].controlName == controlName)
+			{
+				_rScriptsCancelled++;
+				_blockedRScripts.removeAt(i);
+				break;
+			}
+
+	QVector<RScriptRequest>& queue = blocked ? _blockedRScripts : _pendingRScripts;
+
+	for (RScriptRequest & pending : queue)
+		if (pending.controlName == controlName)
+		{
+			// Only the last request of a control matters
+			if (pending.hash == request.hash)	_rScriptsCoalesced++;
+			else								_rScriptsCancelled++;
+
+			pending = request;
+			return;
+		}
+
+	queue.push_back(request);
+
+	if (!blocked && !_sendRScriptsScheduled)
 	{
-		if(_valueChangedSignalsBlocked == 0)	_analysis->sendRScript(script, controlName, whiteListedVersion);
-		else									_waitingRScripts.push(std::make_tuple(script, controlName, whiteListedVersion));
+		_sendRScriptsScheduled = true;
+		QTimer::singleShot(0, this, &AnalysisForm::sendPendingRScripts);
+	}
+}
+
+void AnalysisForm::_sendRScripts(bool alsoWhileBlocked)
+{
+	_sendRScriptsScheduled = false;
+
+	if(!_analysis || _removed)
+		return;
+
+	// A cached result is given synchronously, and its handler may request new scripts: iterate over a copy of the pending requests.
+	// The requests made while the signals were blocked come after the others: they are newer.
+	QVector<RScriptRequest> requests;
+	requests.swap(_pendingRScripts);
+
+	if (alsoWhileBlocked)
+	{
+		requests += _blockedRScripts;
+		_blockedRScripts.clear();
+	}
+
+	for (const RScriptRequest & request : requests)
+	{
+
+		QString * cachedResult = _rScriptCache.object({request.script, request.whiteListedVersion});
+		if (cachedResult)
+		{
+			_rScriptCacheHits++;
+
+			auto inFlight = _rScriptsInFlight.find(request.controlName);
+			if (inFlight != _rScriptsInFlight.end())
+				inFlight->dropAll = true;
+
+			_rScriptDone(*cachedResult, request.controlName);
+			continue;
+		}
+
+		RScriptsInFlight & inFlight = _rScriptsInFlight[request.controlName];
+		if (inFlight.count > 0 && inFlight.hash == request.hash && !inFlight.dropAll)
+		{
+			// The same script is already running for this control: its reply will do.
+			_rScriptsCoalesced++;
+			continue;
+		}
+
+		inFlight.count++;
+		inFlight.hash				= request.hash;
+		inFlight.script				= request.script;
+		inFlight.whiteListedVersion	= request.whiteListedVersion;
+		inFlight.revision			= _dataSetRevision;
+		inFlight.dropAll			= false;
+		_analysis->sendRScript(request.script, request.controlName, request.whiteListedVersion);
 	}
+
 }
 
 void AnalysisForm::refreshAnalysis()
@@ -105,6 +206,7 @@ void AnalysisForm::cleanUpForm()
 			control->cleanUp();
 
 		_formCompleted = false;
+		clearRScriptsInFlight();
 	}
 }
 
@@ -113,6 +215,25 @@ void AnalysisForm::runScriptRequestDone(const QString& result, const QString& co
 	if(_removed)
 		return;
 
+	auto inFlight = _rScriptsInFlight.find(controlName);
+	if (inFlight != _rScriptsInFlight.end())
+	{
+		if (--inFlight->count > 0 || inFlight->dropAll)
+		{
+			// A newer request of this control is still running, or a cached result was already given: this reply is superseded.
+			_rScriptsCancelled++;
+			if (inFlight->count == 0)
+				_rScriptsInFlight.erase(inFlight);
+			return;
+		}
+
+		// The reply of the R syntax must always go through the parsing of its options below, so it is not cached.
+		if (!hasError && rScriptCacheSize() > 0 && inFlight->revision == _dataSetRevision && controlName != rSyntaxControlName)
+			_rScriptCache.insert({inFlight->script, inFlight->whiteListedVersion}, new QString(result));
+
+		_rScriptsInFlight.erase(inFlight);
+	}
+
 	if (controlName == rSyntaxControlName)
 	{
 		JASPControl* rSyntaxControl = getControl(controlName);
@@ -136,6 +257,11 @@ void AnalysisForm::runScriptRequestDone(const QString& result, const QString& co
 		return;
 	}
 
+	_rScriptDone(result, controlName);
+}
+
+void AnalysisForm::_rScriptDone(const QString &result, const QString &controlName)
+{
 	JASPControl* item = getControl(controlName);
 	if (!item)
 	{
@@ -154,10 +280,37 @@ void AnalysisForm::runScriptRequestDone(const QString& result, const QString& co
 		Log::log() << "Unknown item " << controlName.toStdString() << std::endl;
 }
 
+void AnalysisForm::setRScriptCacheSize(int size)
+{
+	if (size == rScriptCacheSize())
+		return;
+
+	_rScriptCache.setMaxCost(std::max(0, size));
+	emit rScriptCacheSizeChanged();
+}
+
+void AnalysisForm::dataSetChangedHandler()
+{
+	_dataSetRevision++;
+	_rScriptCache.clear();
+}
+
 void AnalysisForm::addControl(JASPControl *control)
 {
 	const QString & name = control->name();
 
+	// Must be connected before the analysis: it asks then the used variables of the form.
+	JASPListControl* listControl = qobject_cast<JASPListControl*>(control);
+	if (listControl)
+		connect(listControl, &JASPControl::usedVariablesChanged, this, [this, listControl]()
+		{
+			QStringList added, removed;
+			_updateUsedVariables(listControl, &added, &removed);
+
+			if (added.size() > 0 || removed.size() > 0)
+				emit usedVariablesChanged(added, removed);
+		});
+
 	if (_analysis && control->isBound())
 	{
 		connect(control, &JASPControl::requestColumnCreation, _analysis, &AnalysisBase::requestColumnCreationHandler);
@@ -262,8 +415,10 @@ QString AnalysisForm::parseOptions(QString options)
 	Json::Value	 jsonOptions;
 	Json::Value jsonResult(Json::objectValue);
 
-	QJsonDocument doc = QJsonDocument::fromJson(options.toUtf8());
-	jsonReader.parse(doc.toJson().toStdString(), jsonOptions, false);
+	// Parse the options only once: the options tree is then used as it is by the controls.
+	std::string optionsStr = fq(options);
+	if (!jsonReader.parse(optionsStr.data(), optionsStr.data() + optionsStr.size(), jsonOptions, false))
+		jsonOptions = Json::nullValue;
 
 	if (!_analysis)
 		setAnalysis(new AnalysisBase(this)); // Create a dummy analyis object
@@ -271,10 +426,11 @@ QString AnalysisForm::parseOptions(QString options)
 	if (_rSyntax->parseRSyntaxOptions(jsonOptions))
 	{
 		bindTo(jsonOptions);
-		jsonOptions = _analysis->boundValues();
+		jsonResult["options"] = _analysis->boundValues();
 	}
+	else
+		jsonResult["options"].swap(jsonOptions);
 
-	jsonResult["options"] = jsonOptions;
 	jsonResult["error"] = fq(getError());
 	return tq(jsonResult.toStyledString());
 }
@@ -291,19 +447,26 @@ void AnalysisForm::_setUp()
 	for (JASPControl* control : controls)
 	{
 		_dependsOrderedCtrls.push_back(control);
-		connect(control, &JASPControl::helpMDChanged, this, &AnalysisForm::helpMDChanged);
+		connect(control, &JASPControl::helpMDChanged, this, &AnalysisForm::helpMDChangedHandler);
 	}
 
 	_rSyntax->setUp();
 
-	emit helpMDChanged(); //Because we just got info on our lovely children in _orderedControls
+	helpMDChangedHandler(); //Because we just got info on our lovely children in _orderedControls
 }
 
 void AnalysisForm::reset()
 {
+	clearRScriptsInFlight();
 	_analysis->reloadForm();
 }
 
+void AnalysisForm::clearRScriptsInFlight()
+{
+	// The replies of these requests may never come (the form or the analysis was reset, the engine restarted...): they should not keep identical requests from being sent.
+	_rScriptsInFlight.clear();
+}
+
 void AnalysisForm::exportResults()
 {
     _analysis->exportResults();
@@ -371,29 +534,37 @@ void AnalysisForm::_addLoadingError(QStringList wrongJson)
 void AnalysisForm::bindTo(const Json::Value & defaultOptions)
 {
 	std::set<std::string> controlsJsonWrong;
+
+	clearRScriptsInFlight();
 	
 	for (JASPControl* control : _dependsOrderedCtrls)
 	{
-		BoundControl* boundControl = control->boundControl();
-		Json::Value optionValue = Json::nullValue;
+		BoundControl*		boundControl	= control->boundControl();
+		const Json::Value*	optionValue		= &Json::Value::null;
 		if (boundControl)
 		{
-			std::string name = control->name().toStdString();
-			if (defaultOptions.isMember(name))
-				optionValue = defaultOptions[name];
+			// Use the value in the options tree as it is, without copying it.
+			std::string			name		= control->name().toStdString();
+			const Json::Value*	found		= defaultOptions.find(name.data(), name.data() + name.size());
 
-			if (optionValue != Json::nullValue && !boundControl->isJsonValid(optionValue))
+			if (found && !found->isNull())
 			{
-				optionValue = Json::nullValue;
-				control->setHasWarning(true);
-				controlsJsonWrong.insert(name);
+				if (boundControl->isJsonValid(*found))
+					optionValue = found;
+				else
+				{
+					control->setHasWarning(true);
+					controlsJsonWrong.insert(name);
+				}
 			}
 		}
 
-		control->setInitialized(optionValue);
+		control->setInitialized(*optionValue);
 	}
 
 	_addLoadingError(tql(controlsJsonWrong));
+	_clearBoundValuesDiff();
+	_usedVariablesKnown = false;
 
 	//Ok we can only set the warnings on the components now, because otherwise _addLoadingError() will add a big fat red warning on top of the analysisform without reason...
 	for (JASPControl* control : _dependsOrderedCtrls)
@@ -548,6 +719,7 @@ void AnalysisForm::setAnalysis(AnalysisBase * analysis)
 		throw std::runtime_error("An analysis of an analysisform was replaced by another analysis, this is decidedly NOT supported!");
 
 	_analysis = analysis;
+	clearRScriptsInFlight();
 
 	Log::log() << "AnalysisForm " << this << " sets Analysis " << _analysis << " on itself" << std::endl;
 
@@ -601,6 +773,10 @@ void AnalysisForm::setAnalysisUp()
 
 	_initialized = true;
 
+	// The help changes during the setup were not signaled: do it once now.
+	if (_helpMDDirty)
+		helpMDChangedHandler();
+
 	// Don't bind boundValuesChanged before it is initialized: each setup of all controls will generate a boundValuesChanged
 	connect(_analysis,					&AnalysisBase::boundValuesChanged,		this,			&AnalysisForm::setRSyntaxText,				Qt::QueuedConnection	);
 
@@ -702,17 +878,15 @@ void AnalysisForm::blockValueChangeSignal(bool block, bool notifyOnceUnblocked)
 			if(notifyOnceUnblocked && _analysis && _valueChangedEmittedButBlocked)
 				_analysis->boundValueChangedHandler();
 
+			if(notifyOnceUnblocked)	emitBoundValuesDiff();
+			else					_clearBoundValuesDiff();
+
 			_valueChangedEmittedButBlocked = false;
 		
 			if(_analysis && (notifyOnceUnblocked || _analysis->wasUpgraded())) //Maybe something was upgraded and we want to run the dropped rscripts (for instance for https://github.com/jasp-stats/INTERNAL-jasp/issues/1399)
-				while(_waitingRScripts.size() > 0)
-				{
-					const auto & front = _waitingRScripts.front();
-					_analysis->sendRScript(std::get<0>(front), std::get<1>(front), std::get<2>(front));
-					_waitingRScripts.pop();
-				}
+				_sendRScripts(true);
 			else //Otherwise just clean it up
-				_waitingRScripts = std::queue<std::tuple<QString, QString, bool>>();
+				_blockedRScripts.clear();
 		}
 	}
 }
@@ -857,51 +1031,164 @@ std::vector<std::vector<string> > AnalysisForm::_getValuesFromJson(const Json::V
 
 void  AnalysisForm::setBoundValue(const string &name, const Json::Value &value, const Json::Value &meta, const QVector<AnalysisBase::ParentKey> &parentKeys)
 {
-	if (_analysis)
-		_analysis->setBoundValue(name, value, meta, parentKeys);
+	if (!_analysis)
+		return;
+
+	// The diff is only computed if it is listened to: then the value of a control before its first change in this event loop is kept.
+	if (isSignalConnected(QMetaMethod::fromSignal(&AnalysisForm::boundValuesDiff)))
+	{
+		std::string key;
+		for (const AnalysisBase::ParentKey& parentKey : parentKeys)
+		{
+			key += parentKey.name + '\t' + parentKey.key;
+			for (const std::string& component : parentKey.value)
+				key += '\t' + component;
+			key += '\n';
+		}
+		key += name;
+
+		if (_pendingBoundValuesIndex.count(key) == 0)
+		{
+			_pendingBoundValuesIndex[key] = _pendingBoundValues.size();
+			_pendingBoundValues.push_back({name, parentKeys, OptionsDiff::path(name, parentKeys), _analysis->boundValue(name, parentKeys)});
+		}
+
+		if (!_boundValuesDiffScheduled)
+		{
+			_boundValuesDiffScheduled = true;
+			QTimer::singleShot(0, this, &AnalysisForm::emitBoundValuesDiff);
+		}
+	}
+
+	_analysis->setBoundValue(name, value, meta, parentKeys);
 }
 
-std::set<string> AnalysisForm::usedVariables()
+void AnalysisForm::emitBoundValuesDiff()
 {
-	std::set<string> result;
+	_boundValuesDiffScheduled = false;
+
+	// When the signals are blocked, the changes are gathered until they are unblocked.
+	if (_valueChangedSignalsBlocked > 0)
+		return;
+
+	// Only the values set since the last diff are compared
+	OptionsDiff::Diff diff;
+
+	for (const PendingBoundValue& pending : _pendingBoundValues)
+	{
+		const Json::Value& newValue = boundValue(pending.name, pending.parentKeys);
+
+		if (newValue == pending.oldValue)
+			continue;
+
+		OptionsDiff::Change::Type type =	pending.oldValue.isNull()	? OptionsDiff::Change::Type::Added		:
+											newValue.isNull()			? OptionsDiff::Change::Type::Removed	:
+																		  OptionsDiff::Change::Type::Changed;
+
+		diff.push_back({type, pending.name, pending.path, pending.oldValue, newValue});
+	}
+
+	_clearBoundValuesDiff();
+
+	if (!diff.empty())
+		emit boundValuesDiff(diff);
+}
+
+void AnalysisForm::_resetUsedVariables()
+{
+	_usedVariablesCount.clear();
+	_usedVariablesPerControl.clear();
+	_usedVariablesKnown = true;
 
 	for (JASPControl* control : _controls)
 	{
 		JASPListControl* listControl = qobject_cast<JASPListControl*>(control);
 		if (listControl)
+			_updateUsedVariables(listControl);
+	}
+}
+
+void AnalysisForm::_updateUsedVariables(JASPListControl* control, QStringList* added, QStringList* removed)
+{
+	if (!_usedVariablesKnown)
+		return; // They will be all computed when asked
+
+	std::vector<std::string>	newVariables = control->usedVariables();
+	std::vector<std::string>&	oldVariables = _usedVariablesPerControl[control];
+
+	// A control using several times the same variable counts only once.
+	std::sort(newVariables.begin(), newVariables.end());
+	newVariables.erase(std::unique(newVariables.begin(), newVariables.end()), newVariables.end());
+
+	std::vector<std::string> addedVariables, removedVariables;
+	std::set_difference(newVariables.begin(), newVariables.end(), oldVariables.begin(), oldVariables.end(), std::back_inserter(addedVariables));
+	std::set_difference(oldVariables.begin(), oldVariables.end(), newVariables.begin(), newVariables.end(), std::back_inserter(removedVariables));
+
+	for (const std::string& variable : addedVariables)
+		if (_usedVariablesCount[variable]++ == 0 && added)
+			added->append(tq(variable));
+
+	for (const std::string& variable : removedVariables)
+		if (--_usedVariablesCount[variable] == 0)
 		{
-			std::vector<std::string> usedVariables = listControl->usedVariables();
-			result.insert(usedVariables.begin(), usedVariables.end());
+			_usedVariablesCount.erase(variable);
+			if (removed)
+				removed->append(tq(variable));
 		}
-	}
+
+	oldVariables = std::move(newVariables);
+}
+
+std::set<string> AnalysisForm::usedVariables()
+{
+	if (!_usedVariablesKnown)
+		_resetUsedVariables();
+
+	std::set<string> result;
+
+	for (const auto& variable : _usedVariablesCount)
+		result.insert(variable.first);
 
 	return result;
 }
 
+bool AnalysisForm::isVariableUsed(const std::string &name)
+{
+	if (!_usedVariablesKnown)
+		_resetUsedVariables();
+
+	return _usedVariablesCount.count(name) > 0;
+}
+
 ///Generates documentation based on the "info" entered on each component
 QString AnalysisForm::helpMD() const
 {
 	if(!_analysis) return "";
 
-	QStringList markdown =
+	if (_helpMDDirty)
 	{
-		title(), "\n",
-		"=====================\n",
-		_info, "\n\n",
-		"---\n# ", tr("Options"), "\n"
-	};
+		QStringList markdown =
+		{
+			title(), "\n",
+			"=====================\n",
+			_info, "\n\n",
+			"---\n# ", tr("Options"), "\n"
+		};
 
-	QList<JASPControl*> orderedControls = JASPControl::getChildJASPControls(this);
+		QList<JASPControl*> orderedControls = JASPControl::getChildJASPControls(this);
 
-	std::set<const JASPControl *> markdowned;
+		std::set<const JASPControl *> markdowned;
 
-	for(JASPControl * control : orderedControls)
-		if(!markdowned.count(control))
-			markdown.push_back(control->helpMD(markdowned));
+		for(JASPControl * control : orderedControls)
+			if(!markdowned.count(control))
+				markdown.push_back(control->helpMD(markdowned));
 
-	markdown.push_back(metaHelpMD());
-	
-	QString md = markdown.join("");
+		_helpMDCache = markdown.join("");
+		_helpMDDirty = false;
+	}
+
+	// The results meta has no change signal, so this part is not cached.
+	QString md = _helpMDCache + metaHelpMD();
 	
 	if(_analysis)
 		_analysis->preprocessMarkdownHelp(md);
@@ -909,6 +1196,24 @@ QString AnalysisForm::helpMD() const
 	return md;
 }
 
+void AnalysisForm::helpMDChangedHandler()
+{
+	_helpMDDirty = true;
+
+	// While the form is loading, nobody can show its help yet: the change is signaled once it is initialized.
+	if (!_initialized || _helpMDChangedScheduled)
+		return;
+
+	_helpMDChangedScheduled = true;
+	QTimer::singleShot(0, this, &AnalysisForm::emitHelpMDChanged);
+}
+
+void AnalysisForm::emitHelpMDChanged()
+{
+	_helpMDChangedScheduled = false;
+	emit helpMDChanged();
+}
+
 ///Collects "info" from results and lists them underneath the output in the help-md window
 QString AnalysisForm::metaHelpMD() const
 {
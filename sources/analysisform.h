@@ -28,13 +28,17 @@
 #include "models/listmodel.h"
 #include "models/listmodeltermsavailable.h"
 #include "messageforwarder.h"
+#include "optionsdiff.h"
 #include "qutils.h"
-#include <queue>
+#include <QVector>
+#include <QCache>
+#include <unordered_map>
 
 class ListModelTermsAssigned;
 class JASPControl;
 class ExpanderButtonBase;
 class RSyntax;
+class VariableInfoCache;
 
 ///
 /// The backend for the `Form{}` used in all JASP's well, qml forms
@@ -65,6 +69,7 @@ class AnalysisForm : public AnalysisFormBase
 	Q_PROPERTY(bool			showAllROptions			READ showAllROptions		WRITE setShowAllROptions		NOTIFY showAllROptionsChanged		)
 	Q_PROPERTY(QString		rSyntaxControlName		MEMBER rSyntaxControlName	CONSTANT															)
 	Q_PROPERTY(JASPControl*	activeJASPControl		READ getActiveJASPControl									NOTIFY activeJASPControlChanged		)
+	Q_PROPERTY(int			rScriptCacheSize		READ rScriptCacheSize		WRITE setRScriptCacheSize		NOTIFY rScriptCacheSizeChanged		)
 
 public:
 	explicit				AnalysisForm(QQuickItem * = nullptr);
@@ -73,6 +78,11 @@ public:
 	void					bindTo(const Json::Value & defaultOptions);
 
 	void					runRScript(QString script, QString controlName, bool whiteListedVersion);
+	int						rScriptsCoalesced()				const	{ return _rScriptsCoalesced;	}
+	int						rScriptsCancelled()				const	{ return _rScriptsCancelled;	}
+	int						rScriptCacheSize()				const	{ return _rScriptCache.maxCost();	}
+	int						rScriptCacheHits()				const	{ return _rScriptCacheHits;		}
+	void					clearRScriptsInFlight();	///< To call when the replies of the requests sent may not come anymore, e.g. when the engine is restarted.
 
 	void					itemChange(QQuickItem::ItemChange change, const QQuickItem::ItemChangeData &value)	override;
 
@@ -106,6 +116,8 @@ public slots:
 	void					setDeveloperMode(bool developerMode)				override;
 	void					setRSyntaxText();
 	void					setShowAllROptions(bool showAllROptions);
+	void					setRScriptCacheSize(int size);
+	void					dataSetChangedHandler();
 	void					sendRSyntax(QString text);
 	void					toggleRSyntax();
 
@@ -115,6 +127,7 @@ signals:
 	void					errorMessagesItemChanged();
 	void					hasVolatileNotesChanged();
 	void					runOnChangeChanged();
+	void					rScriptCacheSizeChanged();
 	void					infoChanged();
 	void					helpMDChanged();
 	void					errorsChanged();
@@ -126,6 +139,8 @@ signals:
 	void					rSyntaxTextChanged();
 	void					showAllROptionsChanged();
 	void					activeJASPControlChanged();
+	void					usedVariablesChanged(const QStringList& added, const QStringList& removed);
+	void					boundValuesDiff(const OptionsDiff::Diff& diff); ///< Emitted once per batch of bound value changes, with the values that were added, removed or changed by each control. Only computed if this signal is connected.
 
 public:
 	ListModel			*	getModel(const QString& modelName)								const	{ return _modelMap.count(modelName) > 0 ? _modelMap[modelName] : nullptr;	} // Maps create elements if they do not exist yet
@@ -164,6 +179,7 @@ public:
 	QString			warnings()				const	{ return msgsListToString(_formWarnings);	}
 	QVariant		analysis()				const	{ return QVariant::fromValue(_analysis);	}
 	RSyntax*		rSyntax()				const	{ return _rSyntax;							}
+	VariableInfoCache* variableInfoCache()	const	{ return _variableInfoCache;				}
 	QString			generateRSyntax(bool useHtml = false)	const	override;
 	QVariantList	optionNameConversion()	const;
 	bool			isFormulaName(const QString& name)		const;
@@ -174,7 +190,9 @@ public:
 	const Json::Value& boundValues()		const { return _analysis ? _analysis->boundValues() : Json::Value::null; }
 	const Json::Value& boundValue(const std::string& name, const QVector<AnalysisBase::ParentKey>& parentKeys) { return _analysis ? _analysis->boundValue(name, parentKeys) : Json::Value::null; }
 	void			setBoundValue(const std::string& name, const Json::Value& value, const Json::Value& meta, const QVector<AnalysisBase::ParentKey>& parentKeys = {});
+	bool			applyBoundValuesDiff(Json::Value& options, const OptionsDiff::Diff& diff) const { return OptionsDiff::applyDiff(options, diff); }
 	stringset		usedVariables()									override;
+	bool			isVariableUsed(const std::string& name);
 
 	void			sortControls(QList<JASPControl*>& controls);
 	QString			getSyntaxName(const QString& name)				const;
@@ -196,10 +214,19 @@ private:
 	void			setControlIsDependency(	std::string controlName, bool isDependency)					{ setControlIsDependency(tq(controlName), isDependency);	}
 	void			setControlMustContain(	std::string controlName, std::set<std::string> containThis)	{ setControlMustContain(tq(controlName), tql(containThis)); }
 	void			setAnalysisUp();
+	void			_sendRScripts(bool alsoWhileBlocked);
+	void			_rScriptDone(const QString& result, const QString& controlName);
+	void			_clearBoundValuesDiff()							{ _pendingBoundValues.clear(); _pendingBoundValuesIndex.clear(); }
+	void			_resetUsedVariables();
+	void			_updateUsedVariables(JASPListControl* control, QStringList* added = nullptr, QStringList* removed = nullptr);
 	stringvecvec	_getValuesFromJson(const Json::Value& jsonValues, const QStringList& searchPath);
 	QString			msgsListToString(const QStringList & list) const;
 
 private slots:
+	   void			sendPendingRScripts()			{ _sendRScripts(false); }
+	   void			emitBoundValuesDiff();
+	   void			helpMDChangedHandler();
+	   void			emitHelpMDChanged();
 	   void			formCompletedHandler();
 	   void			knownIssuesUpdated();
 
@@ -227,8 +254,55 @@ private:
 													_valueChangedEmittedButBlocked	= false;
 	QString											_info;
 	int												_valueChangedSignalsBlocked		= 0;
-	std::queue<std::tuple<QString, QString, bool>>	_waitingRScripts; //Sometimes signals are blocked, and thus rscripts. But they shouldnt just disappear right?
+	///An R script request of a control. The requests are sent once per event loop, and only the last one of each control is kept: its reply is dispatched by control name, so only the last reply matters anyway.
+	struct RScriptRequest
+	{
+		QString		script,
+					controlName;
+		bool		whiteListedVersion;
+		size_t		hash;
+	};
+	///Requests sent to R but not yet answered, per control. If more than one is in flight, the replies of all but the last one are dropped.
+	struct RScriptsInFlight
+	{
+		int			count		= 0;
+		size_t		hash		= 0;
+		QString		script;
+		bool		whiteListedVersion	= false,
+					dropAll		= false;	// A cached result was given to the control after these requests were sent
+		int			revision	= 0;
+	};
+	QVector<RScriptRequest>							_pendingRScripts,
+													_blockedRScripts;	//Requested while the signals were blocked: they are sent when the signals are unblocked with notification, or dropped otherwise.
+	QMap<QString, RScriptsInFlight>					_rScriptsInFlight;
+	bool											_sendRScriptsScheduled			= false;
+	int												_rScriptsCoalesced				= 0,
+													_rScriptsCancelled				= 0,
+													_rScriptCacheHits				= 0,
+													_dataSetRevision				= 0;
+	///Results of the R scripts of this form, only used if the form sets a rScriptCacheSize: a script result depends only on the script and on the data set, so it is cleared when the data changes.
+	QCache<QPair<QString, bool>, QString>			_rScriptCache;
+	///Bound values set since the last boundValuesDiff, with their value before the first change: only these are compared when the diff is emitted.
+	struct PendingBoundValue
+	{
+		std::string							name;
+		QVector<AnalysisBase::ParentKey>	parentKeys;
+		Json::Value							path,
+											oldValue;
+	};
+	std::vector<PendingBoundValue>					_pendingBoundValues;
+	std::unordered_map<std::string, size_t>			_pendingBoundValuesIndex;	// Index in _pendingBoundValues per control name and parent keys
+	///Variables used by the list controls, with the number of controls using them, and what each control uses.
+	std::unordered_map<std::string, int>			_usedVariablesCount;
+	QMap<JASPListControl*, std::vector<std::string>>	_usedVariablesPerControl;
+	bool											_usedVariablesKnown				= false;
+	bool											_boundValuesDiffScheduled		= false;
+	///Markdown of the title, info and controls, generated only when helpMD is read, and marked dirty when one of them changes.
+	mutable QString									_helpMDCache;
+	mutable bool									_helpMDDirty					= true;
+	bool											_helpMDChangedScheduled			= false;
 	RSyntax										*	_rSyntax						= nullptr;
+	VariableInfoCache							*	_variableInfoCache				= nullptr;
 	bool											_showRButton					= false,
 													_developerMode					= false;
 	QString											_rSyntaxText;
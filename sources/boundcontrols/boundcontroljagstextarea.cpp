@@ -19,6 +19,19 @@
 #include "boundcontroljagstextarea.h"
 #include "controls/textareabase.h"
 #include "columnencoder.h"
+#include "log.h"
+
+BoundControlJAGSTextArea::BoundControlJAGSTextArea(TextAreaBase* textArea) : BoundControlTextArea(textArea)
+{
+	VariableInfo* variableInfo = VariableInfo::info();
+	if (variableInfo)
+	{
+		// A column added or removed changes the rowCount of VariableInfo
+		QObject::connect(variableInfo,	&VariableInfo::columnsChanged,	textArea,	[this]() { _columnNamesTrieValid = false; });
+		QObject::connect(variableInfo,	&VariableInfo::namesChanged,	textArea,	[this]() { _columnNamesTrieValid = false; });
+		QObject::connect(variableInfo,	&VariableInfo::rowCountChanged,	textArea,	[this]() { _columnNamesTrieValid = false; });
+	}
+}
 
 void BoundControlJAGSTextArea::bindTo(const Json::Value &value)
 {
@@ -27,6 +40,7 @@ void BoundControlJAGSTextArea::bindTo(const Json::Value &value)
 
 	_textArea->setText(tq(value["modelOriginal"].asString()));
 
+	_resetSyntaxCheck();
 	checkSyntax();
 
 }
@@ -55,44 +69,182 @@ bool BoundControlJAGSTextArea::isJsonValid(const Json::Value &value) const
 	return true;
 }
 
-void BoundControlJAGSTextArea::checkSyntax()
+void BoundControlJAGSTextArea::ColumnNamesTrie::add(const QString &name)
 {
-	QString text = _textArea->text();
+	int node = 0;
 
-	// google: jags_user_manual (4.3.0) for documentation on JAGS symbols
+	for (QChar c : name)
+	{
+		auto it = nodes[size_t(node)].children.constFind(c);
+		if (it != nodes[size_t(node)].children.constEnd())
+			node = it.value();
+		else
+		{
+			nodes.push_back(Node());
+			int child = int(nodes.size()) - 1;
+			nodes[size_t(node)].children.insert(c, child);
+			node = child;
+		}
+	}
 
-	// get the column names of the data set
-	_usedColumnNames.clear();
-	_textEncoded = tq(ColumnEncoder::columnEncoder()->encodeRScript(stringUtils::stripRComments(fq(text)), &_usedColumnNames));
+	nodes[size_t(node)].isName = true;
+}
 
-	QRegularExpression relationSymbol = QRegularExpression("<-|=|~");
-	QStringList textByLine = _textEncoded.split(QRegularExpression(";|\n"));
-	_usedParameters.clear();
+const BoundControlJAGSTextArea::ColumnNamesTrie &BoundControlJAGSTextArea::_columnNames()
+{
+	if (!_columnNamesTrieValid)
+	{
+		_columnNamesTrie = ColumnNamesTrie();
+
+		for (const QString& name : _textArea->model()->requestInfo(VariableInfo::VariableNames).toStringList())
+			if (!name.isEmpty())
+				_columnNamesTrie.add(name);
+
+		_columnNamesTrieValid = true;
+	}
+
+	return _columnNamesTrie;
+}
+
+BoundControlJAGSTextArea::LexResult BoundControlJAGSTextArea::_lex(const QString &text, const ColumnNamesTrie& columnNames)
+{
+	// This does in one pass what stripRComments, encodeRScript and the splitting in statements & relation symbols did one after the other:
+	// comments are skipped, the column names are encoded and the left hand side of each statement is kept.
+	// As encodeRScript, a column name (which may contain any character) is encoded where it is not preceded or followed by a letter, digit, '.' or '_',
+	// and not followed by '(' (then it is a function). Strings only matter to know whether a '#' starts a comment.
+	LexResult		result;
+	QString		&	out				= result.textEncoded;
+
+	out.reserve(text.size());
+
+	auto isNameChar = [](QChar c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '.' || c == '_'; };
+
+	const int length = text.size();
+
+	// Returns the length of the longest column name at pos, or 0. The characters of the text are followed in the trie of the column names,
+	// so a position costs at most the length of the longest name it begins with.
+	auto columnNameAt = [&](int pos, bool inString) -> int
+	{
+		if (pos > 0 && isNameChar(text[pos - 1]))
+			return 0;
+
+		int nameLength = 0,
+			node = 0;
+
+		for (int nameEnd = pos; nameEnd < length; )
+		{
+			if (!inString && text[nameEnd] == '#') // The comment starting at '#' is stripped first
+				break;
+
+			auto it = columnNames.nodes[size_t(node)].children.constFind(text[nameEnd]);
+			if (it == columnNames.nodes[size_t(node)].children.constEnd())
+				break;
+
+			node = it.value();
+			nameEnd++;
+
+			if (columnNames.nodes[size_t(node)].isName && (nameEnd == length || (!isNameChar(text[nameEnd]) && text[nameEnd] != '(')))
+				nameLength = nameEnd - pos;
+		}
+
+		return nameLength;
+	};
+
+	int		statementStart	= 0;	// position in out
+	bool	relationFound	= false;
+	QChar	stringDelimiter;
+	bool	inString		= false;
 
-	for (QString & line : textByLine)
+	for (int pos = 0; pos < length; pos++)
 	{
-		// comments were already removed by stringUtils::stripRComments
-		if (line.contains(relationSymbol))
+		QChar c = text[pos];
+
+		if (!inString && c == '#')
 		{
-			// extract parameter and remove whitespace
-			QString paramName = line.split(relationSymbol).first().trimmed();
-			// remove any link functions (cloglog|log|probit|logit)
-			if (paramName.contains("(") && paramName.contains(")"))
+			while (pos + 1 < length && text[pos + 1] != '\n')
+				pos++;
+			continue;
+		}
+
+		if (int nameLength = columnNameAt(pos, inString))
+		{
+			std::string nameStd = fq(text.mid(pos, nameLength));
+			if (ColumnEncoder::columnEncoder()->shouldEncode(nameStd))
 			{
-				int idxStart, idxEnd;
-				idxStart = paramName.indexOf("(") + 1;
-				idxEnd   = paramName.indexOf(")") - idxStart;
-                paramName = paramName.mid(idxStart, idxEnd);
+				result.usedColumnNames.insert(nameStd);
+				out.append(tq(ColumnEncoder::columnEncoder()->encode(nameStd)));
+				pos += nameLength - 1;
+				continue;
 			}
+		}
 
-			// get rid of any indexing
-			if (paramName.contains("["))
-                paramName = paramName.left(paramName.indexOf("["));
-
-			if (paramName != "" && !ColumnEncoder::columnEncoder()->shouldDecode(fq(paramName)))
-				_usedParameters.insert(paramName);
+		if (c == '"' || c == '\'')
+		{
+			if (!inString)					{ inString = true; stringDelimiter = c; }
+			else if (c == stringDelimiter)	inString = false;
+		}
 
+		if (c == ';' || c == '\n')
+		{
+			statementStart	= out.size() + 1; // + 1 for the separator appended below
+			relationFound	= false;
 		}
+		else if ((c == '<' && pos + 1 < length && text[pos + 1] == '-') || c == '=' || c == '~')
+		{
+			if (!relationFound)
+				result.leftHandSides.append(out.mid(statementStart, out.size() - statementStart));
+			relationFound = true;
+		}
+
+		out.append(c);
+	}
+
+	return result;
+}
+
+QString BoundControlJAGSTextArea::_parameterName(QString paramName)
+{
+	// extract parameter and remove whitespace
+	paramName = paramName.trimmed();
+
+	// remove any link functions (cloglog|log|probit|logit)
+	if (paramName.contains("(") && paramName.contains(")"))
+	{
+		int idxStart, idxEnd;
+		idxStart = paramName.indexOf("(") + 1;
+		idxEnd   = paramName.indexOf(")") - idxStart;
+		paramName = paramName.mid(idxStart, idxEnd);
+	}
+
+	// get rid of any indexing
+	if (paramName.contains("["))
+		paramName = paramName.left(paramName.indexOf("["));
+
+	return paramName;
+}
+
+void BoundControlJAGSTextArea::checkSyntax()
+{
+	QString text = _textArea->text();
+
+	// google: jags_user_manual (4.3.0) for documentation on JAGS symbols
+
+	LexResult lexResult = _lex(text, _columnNames());
+
+	// The encoded text changes if the column names used in the model change: if it is the same, the bound value and the parameters are the same as well.
+	if (!_syntaxCheckNeeded(text, lexResult.textEncoded))
+		return;
+
+	_usedColumnNames	= lexResult.usedColumnNames;
+	_textEncoded		= lexResult.textEncoded;
+	_usedParameters.clear();
+
+	for (const QString & leftHandSide : lexResult.leftHandSides)
+	{
+		QString paramName = _parameterName(leftHandSide);
+
+		if (paramName != "" && !ColumnEncoder::columnEncoder()->shouldDecode(fq(paramName)))
+			_usedParameters.insert(paramName);
 	}
 
 	Json::Value boundValue(Json::objectValue);
@@ -21,11 +21,12 @@
 
 #include "boundcontroltextarea.h"
 #include <QSet>
+#include <QHash>
 
 class BoundControlJAGSTextArea : public BoundControlTextArea
 {
 public:
-	BoundControlJAGSTextArea(TextAreaBase* textArea) : BoundControlTextArea(textArea) {}
+	BoundControlJAGSTextArea(TextAreaBase* textArea);
 
 	bool		isJsonValid(const Json::Value& optionValue)		const	override;
 	Json::Value	createJson()									const	override;
@@ -34,6 +35,34 @@ public:
 	void		checkSyntax()											override;
 
 private:
+	///Result of the one pass lexing of a JAGS model: the model without comments and with encoded column names, the used column names, and the part of each statement (separated by ';' or a newline) before its relation symbol (<-, = or ~).
+	struct LexResult
+	{
+		QString						textEncoded;
+		std::set<std::string>		usedColumnNames;
+		QStringList					leftHandSides;
+	};
+
+	///Trie of the column names, to find the longest column name at some position of a text by following its characters.
+	struct ColumnNamesTrie
+	{
+		struct Node
+		{
+			QHash<QChar, int>	children;
+			bool				isName		= false;
+		};
+
+		std::vector<Node>		nodes		= { Node() };
+
+		void					add(const QString& name);
+	};
+
+	static LexResult			_lex(const QString& text, const ColumnNamesTrie& columnNames);
+	static QString				_parameterName(QString leftHandSide);
+	const ColumnNamesTrie&		_columnNames();
+
+	ColumnNamesTrie				_columnNamesTrie;
+	bool						_columnNamesTrieValid = false;	///< The trie is built when a model is checked and invalidated when the columns of the dataset change
 	std::set<std::string>		_usedColumnNames;
 	QSet<QString>				_usedParameters;
 	QString						_textEncoded;
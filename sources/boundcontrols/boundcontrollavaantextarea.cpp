@@ -44,8 +44,12 @@ void BoundControlLavaanTextArea::bindTo(const Json::Value &value)
 	if (value.type() != Json::objectValue)	return;
 	BoundControlBase::bindTo(value);
 
-	_textArea->setText(tq(value["modelOriginal"].asString()));
+	QString text = tq(value["modelOriginal"].asString());
+	if (_lavaanHighlighter)
+		_lavaanHighlighter->highlightInBackground(text);
+	_textArea->setText(text);
 
+	_resetSyntaxCheck();
 	checkSyntax();
 
 }
@@ -78,8 +82,16 @@ void BoundControlLavaanTextArea::checkSyntax()
 	QString text = _textArea->text();
 
 	// get the column names of the data set
-	_usedColumnNames.clear();
-	_textEncoded = tq(ColumnEncoder::columnEncoder()->encodeRScript(stringUtils::stripRComments(fq(text)), &_usedColumnNames));
+	std::set<std::string>	usedColumnNames;
+	QString					textEncoded = tq(ColumnEncoder::columnEncoder()->encodeRScript(stringUtils::stripRComments(fq(text)), &usedColumnNames));
+
+	// If neither the model nor the column names it uses have changed, R would give the same answer: do not ask it again.
+	// This happens typically when a column is added to the data set (rowCountChanged) or when the model is applied twice.
+	if (!_syntaxCheckNeeded(text, textEncoded))
+		return;
+
+	_usedColumnNames	= usedColumnNames;
+	_textEncoded		= textEncoded;
 
 	// Create R code string
 	QString encodedColNames = "c(";
@@ -106,7 +118,10 @@ void BoundControlLavaanTextArea::checkSyntax()
 QString BoundControlLavaanTextArea::rScriptDoneHandler(const QString & result)
 {
 	if (!result.isEmpty())
+	{
+		_resetSyntaxCheck(); // Let the user retry the same model
 		return result;
+	}
 
 	Json::Value boundValue(Json::objectValue);
 
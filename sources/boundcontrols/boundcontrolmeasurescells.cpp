@@ -69,9 +69,31 @@ bool BoundControlMeasuresCells::isJsonValid(const Json::Value &optionValue) cons
 	return optionValue.type() == Json::arrayValue;
 }
 
+int BoundControlMeasuresCells::levelsRevision() const
+{
+	int revision = 0;
+	for (ListModelFactorLevels* factorsModel : _sourceFactorsModels)
+		revision += factorsModel->levelsRevision();
+
+	return revision;
+}
+
 void BoundControlMeasuresCells::addFactorModel(ListModelFactorLevels *factorModel)
 {
 	_sourceFactorsModels.push_back(factorModel);
+
+	// The cells of a factors model come after the cells of the previous ones
+	QObject::connect(factorModel, &ListModelFactorLevels::levelsChanged, _measuresCellsModel, [this, factorModel](const QVector<int>& newCellIndexes, const QVector<int>& changedCells)
+	{
+		int offset = 0;
+		for (ListModelFactorLevels* otherModel : _sourceFactorsModels)
+		{
+			if (otherModel == factorModel) break;
+			offset += int(otherModel->getLevels().size());
+		}
+
+		_measuresCellsModel->updateLevels(offset, newCellIndexes, changedCells, factorModel->getLevels(), levelsRevision());
+	});
 }
 
 void BoundControlMeasuresCells::resetBoundValue()
@@ -37,6 +37,7 @@ public:
 
 	void		addFactorModel(ListModelFactorLevels* factorModel);
 	Terms		getLevels()									const;
+	int			levelsRevision()							const;
 	
 private:
 	ListModelMeasuresCellsAssigned*	_measuresCellsModel;
@@ -44,7 +44,7 @@ void BoundControlMultiTerms::bindTo(const Json::Value& value)
 		values.push_back(rowValues);
 	}
 
-	_listModel->initTerms(values);
+	_listModel->initTuples(values);
 }
 
 Json::Value BoundControlMultiTerms::createJson() const
@@ -59,13 +59,12 @@ bool BoundControlMultiTerms::isJsonValid(const Json::Value &optionValue) const
 
 void BoundControlMultiTerms::resetBoundValue()
 {
-	const QList<Terms>& tuples = _listModel->tuples();
 	Json::Value boundValue(Json::arrayValue);
-	for (const Terms& terms : tuples)
+	for (int row = 0; row < _listModel->tupleCount(); row++)
 	{
-		Json::Value rowValue;
-		for (std::string val : terms.asVector())
-			rowValue.append(val);
+		Json::Value rowValue(Json::arrayValue);
+		for (int col = 0; col < _listModel->columns(); col++)
+			rowValue.append(fq(_listModel->tupleValue(row, col)));
 		boundValue.append(rowValue);
 	}
 
@@ -23,11 +23,15 @@ void BoundControlSourceTextArea::bindTo(const Json::Value &value)
 {
 	BoundControlTextArea::bindTo(value);
 
+	_resetSyntaxCheck();
 	_setSourceTerms();
 }
 
 void BoundControlSourceTextArea::checkSyntax()
 {
+	if (!_syntaxCheckNeeded(_textArea->text(), _textArea->separators().join('\n')))
+		return;
+
 	BoundControlTextArea::checkSyntax();
 	_setSourceTerms();
 }
@@ -65,3 +65,20 @@ void BoundControlTextArea::checkSyntax()
 
 	setBoundValue(fq(text));
 }
+
+bool BoundControlTextArea::_syntaxCheckNeeded(const QString &text, const QString &extraKey)
+{
+	size_t key = qHashMulti(0, int(_textArea->textType()), text, extraKey);
+
+	if (_hasSyntaxCheckKey && key == _syntaxCheckKey)
+	{
+		_syntaxCheckHits++;
+		return false;
+	}
+
+	_syntaxCheckKey		= key;
+	_hasSyntaxCheckKey	= true;
+	_syntaxCheckMisses++;
+
+	return true;
+}
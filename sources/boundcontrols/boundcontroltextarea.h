@@ -37,8 +37,21 @@ public:
 	virtual	void			checkSyntax();
 	virtual QString			rScriptDoneHandler(const QString &result)	{ throw std::runtime_error("runRScript done but handler not implemented!\nImplement an override for RScriptDoneHandler!\nResult was: " + result.toStdString()); };
 
+	int						syntaxCheckHits()					const	{ return _syntaxCheckHits;		}
+	int						syntaxCheckMisses()					const	{ return _syntaxCheckMisses;	}
+
 protected:
+	///Returns false if the last syntax check was done with the same text type, text and extra key (for instance the encoded text, that depends on the column names): the check does not need to be redone.
+	bool					_syntaxCheckNeeded(const QString& text, const QString& extraKey = "");
+	void					_resetSyntaxCheck()							{ _hasSyntaxCheckKey = false;	}
+
 	TextAreaBase*				_textArea	= nullptr;
+
+private:
+	size_t						_syntaxCheckKey		= 0;
+	bool						_hasSyntaxCheckKey	= false;
+	int							_syntaxCheckHits	= 0,
+								_syntaxCheckMisses	= 0;
 };
 
 #endif // BOUNDCONTROLTEXTAREA_H
@@ -32,52 +32,40 @@ void ComboBoxBase::bindTo(const Json::Value& value)
 {
 	_model->resetTermsFromSources();
 
-	std::vector<std::string> values = _model->getValues();
 	std::string selectedValue = value.asString();
 	int index = -1;
 
-	if (values.size() > 0)
+	if (_model->rowCount() > 0)
 	{
 		if (selectedValue.empty())	index = 0;
 		else
 		{
-			auto itr = std::find(values.begin(), values.end(), selectedValue);
+			index = _model->getIndexOfValue(tq(selectedValue));
 
-			if (itr == values.end())
+			if (index == -1)
 			{
 				// Buggy situation: the value is not one of the available values of the DropDown.
 				// This might happen with a corrupted JASP file, or an old bug like https://github.com/jasp-stats/jasp-test-release/issues/1836
 				// Before throwing an error message, let's be a bit flexible: if we can find a value which is case-insensitive equal to the selectedValue,
 				// then we can be confident that it is the right one.
-				auto caseInsensitiveEquals = [&](const std::string& s)
-				{
-					return std::equal(s.begin(), s.end(),
-									  selectedValue.begin(), selectedValue.end(),
-									  [](char a, char b) { return tolower(a) == tolower(b); });
-				};
-				itr = std::find_if(values.begin(), values.end(), caseInsensitiveEquals);
-				if (itr != values.end())
-					Log::log() << "Option " << selectedValue << " in DropDown " << name() << " found but not with the same case: " << *itr << std::endl;
+				index = _model->getIndexOfValueCaseInsensitive(tq(selectedValue));
+				if (index != -1)
+					Log::log() << "Option " << selectedValue << " in DropDown " << name() << " found but not with the same case: " << fq(_model->data(_model->index(index, 0), ListModel::ValueRole).toString()) << std::endl;
 			}
 
-			if (itr == values.end())
+			if (index == -1)
 			{
 				// Try also to find a label equals to the selectedValue.
-				auto labelEqualts = [&](const std::string& s)
-				{
-					return fq(_model->getLabel(tq(s))) == selectedValue;
-				};
-				itr = std::find_if(values.begin(), values.end(), labelEqualts);
-				if (itr != values.end())
+				index = _model->getIndexOfLabel(tq(selectedValue));
+				if (index != -1)
 					Log::log() << "Option " << selectedValue << " in DropDown " << name() << " found but as label." << std::endl;
 			}
 
-			if (itr == values.end())
+			if (index == -1)
 			{
 				addControlError(tr("Unknown option %1 in DropDown %2").arg(tq(selectedValue)).arg(name()));
 				index = 0;
 			}
-			index = int(std::distance(values.begin(), itr));
 		}
 	}
 
@@ -145,21 +133,20 @@ std::vector<std::string> ComboBoxBase::usedVariables() const
 
 void ComboBoxBase::termsChangedHandler()
 {
-	std::vector<std::string> values = _model->getValues();
-	int index = -1;
+	int nbValues	= _model->rowCount(),
+		index		= -1;
 
-	if (values.size() > 0)
+	if (nbValues > 0)
 	{
 		if (initialized())
 		{
-			auto itr = std::find(values.begin(), values.end(), fq(_currentValue));
+			index = _model->getIndexOfValue(_currentValue);
 
-			if (itr == values.end())	index = _getStartIndex();
-			else						index = int(std::distance(values.begin(), itr));
+			if (index == -1)			index = _getStartIndex();
 		}
 		else							index = _getStartIndex();
 
-		if (index < 0 || index > int(values.size())) index = 0;
+		if (index < 0 || index > nbValues) index = 0;
 	}
 
 	_setCurrentProperties(index);
@@ -44,29 +44,110 @@ JASPControl::JASPControl(QQuickItem *parent) : QQuickItem(parent)
 		setProperty("ToolTip.tooltip.font", JaspTheme::currentTheme()->font());
 	}*/
 
-	connect(this, &JASPControl::titleChanged,			this, &JASPControl::helpMDChanged);
-	connect(this, &JASPControl::infoChanged,			this, &JASPControl::helpMDChanged);
-	connect(this, &JASPControl::visibleChanged,			this, &JASPControl::helpMDChanged);
-	connect(this, &JASPControl::visibleChildrenChanged,	this, &JASPControl::helpMDChanged);
-	connect(this, &JASPControl::backgroundChanged,		[this] () { if (!_focusIndicator)		setFocusIndicator(_background); });
-	connect(this, &JASPControl::infoChanged,			[this] () { if (_toolTip.isEmpty())	setToolTip(_info);					});
-	connect(this, &JASPControl::toolTipChanged,			[this] () { setShouldStealHover(!_toolTip.isEmpty());					});
-	connect(this, &JASPControl::hasErrorChanged,		this, &JASPControl::_setFocusBorder);
-	connect(this, &JASPControl::hasWarningChanged,		this, &JASPControl::_setFocusBorder);
-	connect(this, &JASPControl::isDependencyChanged,	this, &JASPControl::_setFocusBorder);
-	connect(this, &JASPControl::shouldShowFocusChanged,	this, &JASPControl::_setFocusBorder);
-	connect(this, &JASPControl::activeFocusChanged,		this, &JASPControl::_setShouldShowFocus);
-	connect(this, &JASPControl::focusOnTabChanged,		this, &JASPControl::_setShouldShowFocus);
-	connect(this, &JASPControl::innerControlChanged,	this, &JASPControl::_setShouldShowFocus);
+	// The reactions to the changes of the properties of the control itself are called directly by their setters:
+	// a form can have thousands of controls, and each connection costs time and memory.
+	// The visibility changes are only needed for the help markdown: they are connected when it is asked (see _trackHelpMD).
 	//connect(this, &JASPControl::implicitWidthChanged,	[this] () { setWidth(implicitWidth());		if (_preferredWidthBinding) setPreferredWidth(int(implicitWidth()), true);		});
 	//connect(this, &JASPControl::implicitHeightChanged,	[this] () { setHeight(implicitHeight());	if (_preferredHeightBinding) setPreferredHeight(int(implicitHeight()), true);	});
-	connect(this, &JASPControl::indentChanged,			[this] () { QQmlProperty(this, "Layout.leftMargin", qmlContext(this)).write( (indent() && JaspTheme::currentTheme()) ? JaspTheme::currentTheme()->indentationLength() : 0); });
-	connect(this, &JASPControl::debugChanged,			[this] () { _setBackgroundColor(); _setVisible(); } );
-	connect(this, &JASPControl::parentDebugChanged,		[this] () { _setBackgroundColor(); _setVisible(); } );
-	connect(this, &JASPControl::toolTipChanged,			[this] () { QQmlProperty(this, "ToolTip.text", qmlContext(this)).write(toolTip()); } );
 	connect(this, &JASPControl::boundValueChanged,		this, &JASPControl::_resetBindingValue);
-	connect(this, &JASPControl::activeFocusChanged,		this, &JASPControl::_setFocus);
-	connect(this, &JASPControl::activeFocusChanged,		this, &JASPControl::_notifyFormOfActiveFocus);
+	connect(this, &JASPControl::activeFocusChanged,		this, &JASPControl::_activeFocusChangedHandler);
+}
+
+void JASPControl::_activeFocusChangedHandler()
+{
+	_setShouldShowFocus();
+	_setFocus();
+	_notifyFormOfActiveFocus();
+}
+
+void JASPControl::_trackHelpMD() const
+{
+	if (_helpMDTracked)
+		return;
+
+	_helpMDTracked = true;
+
+	JASPControl* self = const_cast<JASPControl*>(this);
+	connect(self, &JASPControl::visibleChanged,			self, &JASPControl::helpMDChanged);
+	connect(self, &JASPControl::visibleChildrenChanged,	self, &JASPControl::helpMDChanged);
+}
+
+void JASPControl::setInfo(QString info)
+{
+	if (info != _info)
+	{
+		_info = info;
+		emit infoChanged();
+		emit helpMDChanged();
+
+		if (_toolTip.isEmpty())
+			setToolTip(_info);
+	}
+}
+
+void JASPControl::setToolTip(QString toolTip)
+{
+	if (toolTip != _toolTip)
+	{
+		_toolTip = toolTip;
+		emit toolTipChanged();
+
+		setShouldStealHover(!_toolTip.isEmpty());
+		QQmlProperty(this, "ToolTip.text", qmlContext(this)).write(_toolTip);
+	}
+}
+
+void JASPControl::setTitle(QString title)
+{
+	if (title != _title)
+	{
+		_title = title;
+		emit titleChanged();
+		emit helpMDChanged();
+	}
+}
+
+void JASPControl::setIndent(bool indent)
+{
+	if (indent != _indent)
+	{
+		_indent = indent;
+		emit indentChanged();
+
+		QQmlProperty(this, "Layout.leftMargin", qmlContext(this)).write( (_indent && JaspTheme::currentTheme()) ? JaspTheme::currentTheme()->indentationLength() : 0);
+	}
+}
+
+void JASPControl::setIsDependency(bool isDependency)
+{
+	if (isDependency != _isDependency)
+	{
+		_isDependency = isDependency;
+		emit isDependencyChanged();
+		_setFocusBorder();
+	}
+}
+
+void JASPControl::setShouldShowFocus(bool shouldShowFocus)
+{
+	if (shouldShowFocus != _shouldShowFocus)
+	{
+		_shouldShowFocus = shouldShowFocus;
+		emit shouldShowFocusChanged();
+		_setFocusBorder();
+	}
+}
+
+void JASPControl::setBackground(QQuickItem *background)
+{
+	if (background != _background)
+	{
+		_background = background;
+		emit backgroundChanged();
+
+		if (!_focusIndicator)
+			setFocusIndicator(_background);
+	}
 }
 
 JASPControl::~JASPControl()
@@ -85,6 +166,7 @@ void JASPControl::setFocusOnTab(bool focus)
 	{
 		setActiveFocusOnTab(focus);
 		emit focusOnTabChanged();
+		_setShouldShowFocus();
 	}
 }
 
@@ -101,6 +183,7 @@ void JASPControl::setInnerControl(QQuickItem* control)
 		}
 
 		emit innerControlChanged();
+		_setShouldShowFocus();
 	}
 }
 
@@ -167,6 +250,7 @@ void JASPControl::setHasError(bool hasError)
 	{
 		_hasError = hasError;
 		emit hasErrorChanged();
+		_setFocusBorder();
 	}
 }
 
@@ -176,6 +260,7 @@ void JASPControl::setHasWarning(bool hasWarning)
 	{
 		_hasWarning = hasWarning;
 		emit hasWarningChanged();
+		_setFocusBorder();
 	}
 }
 
@@ -248,6 +333,8 @@ void JASPControl::componentComplete()
 			else
 				_parentListViewKey = context->contextProperty("rowIndex").toString();
 
+			invalidateParentKeys(); // The parent keys may have been asked before the control was attached to its row
+
 			listView->addRowControl(_parentListViewKey, this);
 
 			emit parentListViewChanged();
@@ -359,6 +446,8 @@ void JASPControl::setParentDebug(bool parentDebug)
 		_parentDebug = parentDebug;
 		setParentDebugToChildren(_parentDebug || _debug);
 		emit parentDebugChanged();
+		_setBackgroundColor();
+		_setVisible();
 	}
 }
 
@@ -435,6 +524,8 @@ void JASPControl::setDebug(bool debug)
 		_debug = debug;
 		setParentDebugToChildren(_parentDebug || _debug);
 		emit debugChanged();
+		_setBackgroundColor();
+		_setVisible();
 	}
 }
 
@@ -551,6 +642,8 @@ QString JASPControl::ControlTypeToFriendlyString(ControlType controlType)
 
 QString JASPControl::helpMD(SetConst & markdowned, int howDeep, bool asList) const
 {
+	_trackHelpMD();
+
 	if(!isEnabled())
 		return "";
 
@@ -658,18 +751,25 @@ void JASPControl::reconnectWithYourChildren()
 		connect(child, &JASPControl::helpMDChanged,		this, &JASPControl::helpMDChanged,		Qt::UniqueConnection);
 		connect(child, &JASPControl::hasErrorChanged,	this, &JASPControl::hasErrorChanged,	Qt::UniqueConnection);
 		connect(child, &JASPControl::hasWarningChanged, this, &JASPControl::hasWarningChanged,	Qt::UniqueConnection);
+		//The error & warning of a parent (e.g. an Expander) may come from its children: they are not set through setHasError/setHasWarning
+		connect(child, &JASPControl::hasErrorChanged,	this, &JASPControl::_setFocusBorder,	Qt::UniqueConnection);
+		connect(child, &JASPControl::hasWarningChanged, this, &JASPControl::_setFocusBorder,	Qt::UniqueConnection);
 	}
 
 	//Just in case:
 	emit helpMDChanged();
 	emit hasErrorChanged();
 	emit hasWarningChanged();
+	_setFocusBorder();
 }
 
 void JASPControl::parentListViewKeyChanged(const QString &oldName, const QString &newName)
 {
 	if (oldName == _parentListViewKey)
+	{
 		_parentListViewKey = newName;
+		invalidateParentKeys();
+	}
 }
 
 void JASPControl::setName(const QString &name)
@@ -677,6 +777,7 @@ void JASPControl::setName(const QString &name)
 	if (name != _name && checkOptionName(name))
 	{
 		_name = name;
+		invalidateParentKeys(); // The name of a list control is in the parent keys of its row controls
 		emit nameChanged();
 	}
 }
@@ -744,20 +845,26 @@ QString JASPControl::humanFriendlyLabel() const
 
 }
 
-QVector<AnalysisBase::ParentKey> JASPControl::getParentKeys()
+const QVector<AnalysisBase::ParentKey>& JASPControl::getParentKeys()
 {
-	QVector<AnalysisBase::ParentKey> parentKeys;
+	// The parent keys are asked for each get or set of the bound value: compute them only when they were invalidated.
+	if (_parentKeysValid)
+		return _parentKeys;
+
+	_parentKeys.clear();
+	_parentKeysValid = true;
+
 	JASPListControl* parentControl =  parentListView();
 	QString parentKeyValue = parentListViewKey();
 
 	while (parentControl)
 	{
-		parentKeys.prepend({parentControl->name().toStdString(), parentControl->optionKey().toStdString(), Term::readTerm(parentKeyValue).scomponents()});
+		_parentKeys.prepend({parentControl->name().toStdString(), parentControl->optionKey().toStdString(), Term::readTerm(parentKeyValue).scomponents()});
 		parentKeyValue = parentControl->parentListViewKey();
 		parentControl = parentControl->parentListView();
 	}
 
-	return parentKeys;
+	return _parentKeys;
 }
 
 void JASPControl::runRScript(const QString &script, bool whiteListedVersion)
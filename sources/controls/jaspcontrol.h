@@ -114,7 +114,7 @@ public:
 	QString				title()						const	{ return _title;					}
 	QString				info()						const	{ return _info;						}
 	QString				toolTip()					const	{ return _toolTip;					}
-	QString				helpMDControl()				const	{ SetConst tmp; return helpMD(tmp);	} ///< If someone want to get it from qml they can this way.
+	QString				helpMDControl()				const	{ _trackHelpMD(); SetConst tmp; return helpMD(tmp);	} ///< If someone want to get it from qml they can this way.
 	virtual QString		helpMD(SetConst & markdowned, int howDeep = 2, bool asList = false)	const;
 	bool				isBound()					const	{ return _isBound;					}
 	bool				nameIsOptionValue()			const	{ return _nameIsOptionValue;		}
@@ -152,7 +152,9 @@ public:
 
 	QString				humanFriendlyLabel()		const;
 
-	QVector<AnalysisBase::ParentKey>	getParentKeys();
+	const QVector<AnalysisBase::ParentKey>&	getParentKeys();
+	///The parent keys are cached: they must be invalidated when the row key or the parent list of this control changes, or when the name or option key of a parent list changes.
+	virtual void							invalidateParentKeys()		{ _parentKeysValid = false; }
 
 	static QString					ControlTypeToFriendlyString(ControlType controlType);
 	static QList<JASPControl*>		getChildJASPControls(const QQuickItem* item);
@@ -196,15 +198,16 @@ public slots:
 	void	parentListViewKeyChanged(const QString& oldName, const QString& newName);
 	void	setName(const QString& name);
 
-	GENERIC_SET_FUNCTION(Info					, _info					, infoChanged					, QString		)
-	GENERIC_SET_FUNCTION(ToolTip				, _toolTip				, toolTipChanged				, QString		)
-	GENERIC_SET_FUNCTION(Title					, _title				, titleChanged					, QString		)
+	void	setInfo(			QString		info);
+	void	setToolTip(			QString		toolTip);
+	void	setTitle(			QString		title);
+	void	setIndent(			bool		indent);
+	void	setIsDependency(	bool		isDependency);
+	void	setShouldShowFocus(	bool		shouldShowFocus);
+	void	setBackground(		QQuickItem*	background);
+
 	GENERIC_SET_FUNCTION(IsBound				, _isBound				, isBoundChanged				, bool			)
-	GENERIC_SET_FUNCTION(Indent					, _indent				, indentChanged					, bool			)
-	GENERIC_SET_FUNCTION(IsDependency			, _isDependency			, isDependencyChanged			, bool			)
-	GENERIC_SET_FUNCTION(ShouldShowFocus		, _shouldShowFocus		, shouldShowFocusChanged		, bool			)
 	GENERIC_SET_FUNCTION(ShouldStealHover		, _shouldStealHover		, shouldStealHoverChanged		, bool			)
-	GENERIC_SET_FUNCTION(Background				, _background			, backgroundChanged				, QQuickItem*	)
 	GENERIC_SET_FUNCTION(DependencyMustContain	, _dependencyMustContain, dependencyMustContainChanged	, QStringList	)
 	GENERIC_SET_FUNCTION(ExplicitDepends		, _explicitDepends		, explicitDependsChanged		, QVariant		)
 
@@ -217,6 +220,7 @@ private slots:
 	void	_resetBindingValue();
 	void	_setFocus();
 	void	_notifyFormOfActiveFocus();
+	void	_activeFocusChangedHandler();
 	void	_checkControlName();
 
 signals:
@@ -262,6 +266,7 @@ protected:
 	void				focusInEvent(QFocusEvent* event) override;
 	bool				eventFilter(QObject *watched, QEvent *event) override;
 	bool				checkOptionName(const QString& name);
+	void				_trackHelpMD()				const;
 	void				_addExplicitDependency(const QVariant& depends);
 	bool				dependingControlsAreInitialized();
 	virtual void		_setInitialized(const Json::Value &value);
@@ -291,6 +296,9 @@ protected:
 							_hasUserInteractiveValue	= true,
 							_hasActiveFocus				= false;
 	JASPListControl		*	_parentListView				= nullptr;
+	QVector<AnalysisBase::ParentKey>	_parentKeys;
+	bool					_parentKeysValid			= false;
+	mutable bool			_helpMDTracked				= false;
 	QQuickItem			*	_childControlsArea			= nullptr,
 						*	_innerControl				= nullptr,
 						*	_background					= nullptr,
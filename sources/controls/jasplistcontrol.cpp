@@ -27,8 +27,11 @@
 #include "sourceitem.h"
 #include "jasptheme.h"
 #include "desktopcommunicator.h"
+#include "termswidthcache.h"
 
 #include <QQmlContext>
+#include <QTimer>
+#include <limits>
 
 
 JASPListControl::JASPListControl(QQuickItem *parent)
@@ -158,10 +161,11 @@ void JASPListControl::setUp()
 	connect(this,								&JASPListControl::sourceChanged,			this,	&JASPListControl::sourceChangedHandler);
 	connect(listModel,							&ListModel::termsChanged,					this,	&JASPListControl::_termsChangedHandler);
 	connect(listModel,							&ListModel::termsChanged,					this,	[this]() { emit countChanged(); });
-	connect(listModel,							&ListModel::termsChanged,					this,	&JASPListControl::maxTermsWidthChanged);
-	connect(DesktopCommunicator::singleton(),	&DesktopCommunicator::uiScaleChanged,		this,	&JASPListControl::maxTermsWidthChanged);
-	connect(DesktopCommunicator::singleton(),	&DesktopCommunicator::interfaceFontChanged, this,	&JASPListControl::maxTermsWidthChanged);
+	connect(this,								&JASPListControl::containsVariablesChanged,	this,	[this]() { if (isBound()) emit usedVariablesChanged(); }); // usedVariables depends on containsVariables
+	connect(DesktopCommunicator::singleton(),	&DesktopCommunicator::uiScaleChanged,		this,	&JASPListControl::fontChangedHandler);
+	connect(DesktopCommunicator::singleton(),	&DesktopCommunicator::interfaceFontChanged, this,	&JASPListControl::fontChangedHandler);
 
+	_connectTermsWidth(listModel);
 }
 
 void JASPListControl::cleanUp()
@@ -224,6 +228,17 @@ bool JASPListControl::addRowControl(const QString &key, JASPControl *control)
 	return model() ? model()->addRowControl(key, control) : false;
 }
 
+void JASPListControl::invalidateParentKeys()
+{
+	JASPControl::invalidateParentKeys();
+
+	// The keys of this list are part of the parent keys of its row controls, and of the row controls of their own lists.
+	if (model())
+		for (RowControls* rowControls : model()->getAllRowControls())
+			for (JASPControl* control : rowControls->getJASPControlsMap())
+				control->invalidateParentKeys();
+}
+
 bool JASPListControl::hasRowComponent() const
 {
 	return rowComponent() != nullptr;
@@ -264,13 +279,163 @@ int JASPListControl::count()
 double JASPListControl::maxTermsWidth()
 {
 	if (!model()) return 0;
-	double maxWidth = 0;
 
-	QFontMetricsF& metrics = JaspTheme::fontMetrics();
-	for (const Term& term : model()->terms())
-		maxWidth = std::max(maxWidth, metrics.horizontalAdvance(term.asQString()));
+	if (_termsWidthFontVersion != TermsWidthCache::fontVersion() || _termsWidthCount != model()->terms().size())
+		_resetTermsWidth(false);
+
+	return _maxTermsWidth;
+}
+
+void JASPListControl::_connectTermsWidth(ListModel* listModel)
+{
+	// The rows are still in the model when rowsAboutToBeRemoved is emitted, and already in it when rowsInserted is emitted.
+	// The rows are used as indexes in the terms: models whose rows are not their terms are always rescanned.
+	connect(listModel, &ListModel::rowsAboutToBeRemoved, this, [this](const QModelIndex&, int first, int last)
+	{
+		const Terms& terms = model()->terms();
+		if (!model()->rowsAreTerms() || _termsWidthFontVersion != TermsWidthCache::fontVersion() || _termsWidthCount != terms.size() || last >= int(terms.size()))
+		{
+			_termsWidthCount = std::numeric_limits<size_t>::max(); // Forces a rescan after the removal
+			return;
+		}
+
+		double	maxWidth		= _maxTermsWidth,
+				secondMaxWidth	= _secondMaxTermsWidth;
+		bool	secondMaxKnown	= _secondMaxTermsWidthKnown,
+				needsRescan		= false;
+
+		for (int row = first; row <= last && !needsRescan; row++)
+		{
+			double width = TermsWidthCache::width(terms.at(size_t(row)).asQString());
+
+			if (width >= maxWidth)
+			{
+				if (secondMaxKnown)
+				{
+					maxWidth		= secondMaxWidth;
+					secondMaxKnown	= false;
+				}
+				else
+					needsRescan = true;
+			}
+			else if (secondMaxKnown && width >= secondMaxWidth)
+				secondMaxKnown = false;
+		}
+
+		_termsWidthCount = needsRescan ? std::numeric_limits<size_t>::max() : _termsWidthCount - size_t(last - first + 1);
+		if (!needsRescan)
+			_setMaxTermsWidth(maxWidth, secondMaxWidth, secondMaxKnown);
+	});
+
+	connect(listModel, &ListModel::rowsRemoved, this, [this]()
+	{
+		if (_termsWidthCount != model()->terms().size())
+			_resetTermsWidth();
+	});
+
+	connect(listModel, &ListModel::rowsInserted, this, [this](const QModelIndex&, int first, int last)
+	{
+		const Terms& terms = model()->terms();
+		if (!model()->rowsAreTerms() || _termsWidthFontVersion != TermsWidthCache::fontVersion() || _termsWidthCount + size_t(last - first + 1) != terms.size())
+		{
+			_resetTermsWidth();
+			return;
+		}
+
+		double	previousMax = _maxTermsWidth;
+
+		for (int row = first; row <= last; row++)
+			_addTermWidth(TermsWidthCache::width(terms.at(size_t(row)).asQString()));
+		_termsWidthCount = terms.size();
+
+		if (previousMax != _maxTermsWidth)
+			emit maxTermsWidthChanged();
+	});
+
+	connect(listModel, &ListModel::modelReset,		this, [this]() { _resetTermsWidth(); });
+	connect(listModel, &ListModel::namesChanged,	this, [this]() { _resetTermsWidth(); });
+	connect(listModel, &ListModel::dataChanged,		this, [this](const QModelIndex&, const QModelIndex&, const QVector<int>& roles)
+	{
+		if (roles.isEmpty() || roles.contains(Qt::DisplayRole) || roles.contains(ListModel::NameRole))
+			_resetTermsWidth();
+	});
+	// Safety net for models changing their terms without the standard model signals
+	connect(listModel, &ListModel::termsChanged,	this, [this]()
+	{
+		if (_termsWidthCount != model()->terms().size())
+			_resetTermsWidth();
+	});
+
+	_resetTermsWidth(false);
+}
+
+void JASPListControl::_addTermWidth(double width)
+{
+	if (width > _maxTermsWidth)
+	{
+		_secondMaxTermsWidth		= _maxTermsWidth;
+		_secondMaxTermsWidthKnown	= true;
+		_maxTermsWidth				= width;
+	}
+	else if (_secondMaxTermsWidthKnown && width > _secondMaxTermsWidth)
+		_secondMaxTermsWidth		= width;
+}
+
+void JASPListControl::_resetTermsWidth(bool notify)
+{
+	ListModel* listModel = model();
+	if (!listModel) return;
+
+	_termsWidthFontVersion = TermsWidthCache::fontVersion();
+
+	double	maxWidth		= 0,
+			secondMaxWidth	= 0;
+
+	const Terms& terms = listModel->terms();
+	for (const Term& term : terms)
+	{
+		double width = TermsWidthCache::width(term.asQString());
+		if (width > maxWidth)
+		{
+			secondMaxWidth	= maxWidth;
+			maxWidth		= width;
+		}
+		else if (width > secondMaxWidth)
+			secondMaxWidth	= width;
+	}
+
+	_termsWidthCount = terms.size();
+	_setMaxTermsWidth(maxWidth, secondMaxWidth, true, notify);
+}
+
+void JASPListControl::_setMaxTermsWidth(double maxWidth, double secondMaxWidth, bool secondMaxKnown, bool notify)
+{
+	bool changed = _maxTermsWidth != maxWidth;
+
+	_maxTermsWidth				= maxWidth;
+	_secondMaxTermsWidth		= secondMaxWidth;
+	_secondMaxTermsWidthKnown	= secondMaxKnown;
+
+	if (changed && notify)
+		emit maxTermsWidthChanged();
+}
+
+void JASPListControl::fontChangedHandler()
+{
+	// Only the first list control getting this signal really clears the cache, the others just see that the font version has changed.
+	TermsWidthCache::fontChanged();
+
+	if (_termsWidthFontVersion != TermsWidthCache::fontVersion())
+		_resetTermsWidth();
+
+	// The font metrics of the theme may be updated only after this signal: check them again once it is handled.
+	QTimer::singleShot(0, this, [this]()
+	{
+		TermsWidthCache::checkFont();
 
-	return maxWidth;
+		if (_termsWidthFontVersion != TermsWidthCache::fontVersion())
+			_resetTermsWidth();
+	});
 }
 
 std::vector<std::string> JASPListControl::usedVariables() const
@@ -78,6 +78,7 @@ public:
 
 			JASPControl		*	getRowControl(const QString& key, const QString& name)	const;
 	virtual	bool				addRowControl(const QString& key, JASPControl* control);
+			void				invalidateParentKeys()						override;
 			bool				hasRowComponent()			const;
 
 			const QString&		optionKey()					const			{ return _optionKey; }
@@ -130,8 +131,9 @@ protected slots:
 	virtual void				termsChangedHandler(){}; // This slot must be overriden in order to update the options when the model has changed
 			void				_termsChangedHandler();
 			void				sourceChangedHandler();
+			void				fontChangedHandler();
 
-			void				setOptionKey(const QString& optionKey)	{ _optionKey = optionKey; }
+			void				setOptionKey(const QString& optionKey)	{ if (optionKey != _optionKey) { _optionKey = optionKey; invalidateParentKeys(); } }
 
 			GENERIC_SET_FUNCTION(Source,				_source,				sourceChanged,					QVariant		)
 			GENERIC_SET_FUNCTION(RSource,				_rSource,				sourceChanged,					QVariant		)
@@ -169,6 +171,18 @@ protected:
 private:
 	void					_setupSources();
 	Terms					_getCombinedTerms(SourceItem* sourceToCombine);
+	void					_connectTermsWidth(ListModel* listModel);
+	void					_resetTermsWidth(bool notify = true);
+	void					_addTermWidth(double width);
+	void					_setMaxTermsWidth(double maxWidth, double secondMaxWidth, bool secondMaxKnown, bool notify = true);
+
+	// The max width of the terms is kept up to date incrementally: to be able to remove the widest term without rescanning all terms,
+	// the second max width is also tracked. Only when this one is unknown (it was itself removed), the widths of all terms are looked up again.
+	double					_maxTermsWidth			= 0,
+							_secondMaxTermsWidth	= 0;
+	bool					_secondMaxTermsWidthKnown	= true;
+	size_t					_termsWidthCount		= 0;
+	int						_termsWidthFontVersion	= -1;
 };
 
 #endif // JASPLISTCONTROL_H
@@ -17,48 +17,152 @@
 //
 
 #include "lavaansyntaxhighlighter.h"
+#include <QTextDocument>
+#include <QTextBlock>
 
 LavaanSyntaxHighlighter::LavaanSyntaxHighlighter(QTextDocument *parent)
 	: QSyntaxHighlighter(parent)
 {
-	
-	HighlightingRule rule;
-	
 	// operators
-	operatorFormat.setForeground(Qt::darkGreen);
-	QStringList operatorPatterns;
-	operatorPatterns << "\\=" << "\\~" << "\\<"
-					 << "\\*" << "\\>" << "\\:"
-					 << "\\%" << "\\|" << "\\+";
-	for (const QString &pattern : operatorPatterns) {
-		rule.pattern = QRegularExpression(pattern);
-		rule.format = operatorFormat;
-		highlightingRules.append(rule);
-	}
-	
+	_formats[int(TokenType::Operator)].setForeground(Qt::darkGreen);
+
 	// variables
-	variableFormat.setToolTip("variable");
-	rule.pattern = QRegularExpression("\\b\\w*\\b");
-	rule.format = variableFormat;
-	highlightingRules.append(rule);
-	
+	_formats[int(TokenType::Variable)].setToolTip("variable");
+
 	// comments
-	commentFormat.setForeground(Qt::darkGray);
-	commentFormat.setFontItalic(true);
-	rule.pattern = QRegularExpression("#[^\n]*");
-	rule.format = commentFormat;
-	highlightingRules.append(rule);
+	_formats[int(TokenType::Comment)].setForeground(Qt::darkGray);
+	_formats[int(TokenType::Comment)].setFontItalic(true);
+}
+
+LavaanSyntaxHighlighter::~LavaanSyntaxHighlighter()
+{
+	_stopWorker();
+}
+
+LavaanSyntaxHighlighter::BlockFormats LavaanSyntaxHighlighter::computeFormats(const QString &text)
+{
+	// A comment goes till the end of the line: as it is the first alternative, operators and variables inside a comment are not matched.
+	static const QRegularExpression rules("(?<comment>#[^\n]*)|(?<operator>[=~<*>:%|+])|(?<variable>\\b\\w+\\b)");
+
+	BlockFormats formats;
+
+	QRegularExpressionMatchIterator matchIterator = rules.globalMatch(text);
+	while (matchIterator.hasNext())
+	{
+		QRegularExpressionMatch match = matchIterator.next();
+		TokenType type	= match.capturedStart("comment")	>= 0 ? TokenType::Comment
+						: match.capturedStart("operator")	>= 0 ? TokenType::Operator
+						: TokenType::Variable;
+		formats.append({int(match.capturedStart()), int(match.capturedLength()), type});
+	}
+
+	return formats;
 }
 
 void LavaanSyntaxHighlighter::highlightBlock(const QString &text)
 {
-	for (const HighlightingRule &rule : highlightingRules)
+	auto it = _cache.constFind(text);
+	if (it == _cache.constEnd())
+	{
+		// This block will be formatted when the worker thread sends its chunk, or at the end if it is not in the text given to the worker
+		if (_backgroundRunning)
+		{
+			_skippedBlocks.insert(text);
+			return;
+		}
+
+		if (_cache.size() > _maxCacheSize)
+			_cache.clear();
+
+		it = _cache.insert(text, computeFormats(text));
+	}
+
+	for (const FormatRange& range : it.value())
+		setFormat(range.start, range.length, _formats[int(range.type)]);
+}
+
+void LavaanSyntaxHighlighter::highlightInBackground(const QString &text)
+{
+	QStringList lines = text.split('\n');
+	if (lines.size() < _backgroundMinLines)
+		return;
+
+	_stopWorker();
+
+	int generation		= ++_generation;
+	_backgroundRunning	= true;
+	_cancelWorker.storeRelaxed(0);
+
+	_worker = QThread::create([this, lines, generation]()
+	{
+		FormatsChunk	chunk;
+		int				firstLine = 0;
+
+		for (int i = 0; i < lines.size() && !_cancelWorker.loadRelaxed(); i++)
+		{
+			chunk.append({lines[i], computeFormats(lines[i])});
+
+			bool last = i == lines.size() - 1;
+			if (chunk.size() >= _chunkSize || last)
+			{
+				QMetaObject::invokeMethod(this, [this, chunk, firstLine, generation, last]() { _applyChunk(chunk, firstLine, generation, last); }, Qt::QueuedConnection);
+				chunk.clear();
+				firstLine = i + 1;
+			}
+		}
+	});
+
+	_lineCount = lines.size();
+	_worker->start();
+}
+
+void LavaanSyntaxHighlighter::_applyChunk(const FormatsChunk &chunk, int firstLine, int generation, bool last)
+{
+	if (generation != _generation)
+		return;
+
+	for (const auto& keyFormats : chunk)
+		_cache.insert(keyFormats.first, keyFormats.second);
+
+	if (last)
+		_backgroundRunning = false;
+
+	if (document()->blockCount() != _lineCount)
 	{
-		QRegularExpressionMatchIterator matchIterator = rule.pattern.globalMatch(text);
-		while (matchIterator.hasNext())
+		// The document is not (anymore) the text given to the worker: once everything is in the cache, format it the usual way
+		if (last)
 		{
-			QRegularExpressionMatch match = matchIterator.next();
-			setFormat(match.capturedStart(), match.capturedLength(), rule.format);
+			_skippedBlocks.clear();
+			rehighlight();
 		}
+		return;
+	}
+
+	QTextBlock block = document()->findBlockByNumber(firstLine);
+	for (int i = 0; i < chunk.size() && block.isValid(); i++, block = block.next())
+		rehighlightBlock(block);
+
+	if (last && !_skippedBlocks.isEmpty())
+	{
+		// The blocks edited while the worker was running were not formatted
+		QSet<QString> skippedBlocks;
+		skippedBlocks.swap(_skippedBlocks);
+
+		for (QTextBlock block = document()->begin(); block.isValid(); block = block.next())
+			if (skippedBlocks.contains(block.text()))
+				rehighlightBlock(block);
 	}
 }
+
+void LavaanSyntaxHighlighter::_stopWorker()
+{
+	if (!_worker)
+		return;
+
+	_cancelWorker.storeRelaxed(1);
+	_worker->wait();
+	delete _worker;
+	_worker				= nullptr;
+	_backgroundRunning	= false;
+	_skippedBlocks.clear();
+}
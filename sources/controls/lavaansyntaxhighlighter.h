@@ -22,22 +22,58 @@
 #include <QSyntaxHighlighter>
 #include <QTextCursor>
 #include <QRegularExpression>
+#include <QHash>
+#include <QSet>
+#include <QThread>
 
+///
+/// Highlights lavaan models: operators, variables and comments.
+/// All rules are combined in one regular expression, and the formats found for a block are cached by the block text,
+/// so that a block that did not change (or a line that appears several times) is not matched again.
+/// When a big model is set, the highlighting can be computed in a worker thread (highlightInBackground): the blocks are then formatted when their chunk is ready.
+///
 class LavaanSyntaxHighlighter : public QSyntaxHighlighter
 {
+	Q_OBJECT
+
 public:
-	LavaanSyntaxHighlighter(QTextDocument *parent);
-	virtual void highlightBlock(const QString &text) override;
-private:
-	struct HighlightingRule
+	enum class TokenType { Operator = 0, Variable, Comment };
+
+	struct FormatRange
 	{
-		QRegularExpression pattern;
-		QTextCharFormat format;
+		int			start;
+		int			length;
+		TokenType	type;
 	};
-	QVector<HighlightingRule> highlightingRules;
-	QTextCharFormat operatorFormat;
-	QTextCharFormat variableFormat;
-	QTextCharFormat commentFormat;
+	typedef QVector<FormatRange>					BlockFormats;
+	typedef QVector<QPair<QString, BlockFormats> >	FormatsChunk;
+
+	LavaanSyntaxHighlighter(QTextDocument *parent);
+	~LavaanSyntaxHighlighter();
+
+	virtual void			highlightBlock(const QString &text) override;
+
+	///To call before a (big) text is set in the document: the formats of its lines are computed in a worker thread.
+	void					highlightInBackground(const QString& text);
+
+	static BlockFormats		computeFormats(const QString& text);
+
+private:
+	void					_applyChunk(const FormatsChunk& chunk, int firstLine, int generation, bool last);
+	void					_stopWorker();
+
+	static const int		_backgroundMinLines	= 500,
+							_chunkSize			= 200,
+							_maxCacheSize		= 20000;
+
+	QTextCharFormat							_formats[3];
+	QHash<QString, BlockFormats>			_cache;
+	QSet<QString>							_skippedBlocks;		///< Texts of the blocks not formatted while the worker was running (e.g. edited meanwhile)
+	QThread								*	_worker				= nullptr;
+	QAtomicInt								_cancelWorker		= 0;
+	int										_generation			= 0,
+											_lineCount			= 0;
+	bool									_backgroundRunning	= false;
 };
 
 #endif // LAVAANSYNTAXHIGHLIGHTER_H
@@ -133,6 +133,7 @@ void SourceItem::connectModels()
 		connect(_sourceListModel,		&ListModel::labelsChanged,			controlModel, &ListModel::sourceLabelsChanged );
 		connect(_sourceListModel,		&ListModel::labelsReordered,		controlModel, &ListModel::sourceLabelsReordered );
 		connect(_sourceListModel,		&ListModel::columnsChanged,			controlModel, &ListModel::sourceColumnsChanged );
+		connect(_sourceListModel,		&ListModel::termsTransactionEnded,	this,			[this]() { if (_resetPending) _resetModel(); });
 	}
 
 	_connected = true;
@@ -166,6 +167,14 @@ void SourceItem::disconnectModels()
 
 void SourceItem::_resetModel()
 {
+	// While the source model is changed by a transaction (e.g. a drag and drop), reset the target only once, when the transaction ends
+	if (_sourceListModel && _sourceListModel->inTermsTransaction())
+	{
+		_resetPending = true;
+		return;
+	}
+	_resetPending = false;
+
 	if (!_isDataSetVariables || !requestInfo(VariableInfo::SignalsBlocked).toBool())
 		_targetListControl->model()->sourceTermsReset();
 }
@@ -115,6 +115,7 @@ private:
 	QString							_conditionExpression;
 	QVector<ConditionVariable>		_conditionVariables;
 	bool							_connected					= false;
+	bool							_resetPending				= false;
 	JASP::CombinationType			_combineTerms				= JASP::CombinationType::NoCombination;
 	int								_onlyTermsWithXComponents	= 0;
 };
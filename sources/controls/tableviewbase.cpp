@@ -54,6 +54,13 @@ void TableViewBase::setUpModel()
 	connect(_tableModel, &ListModelTableViewBase::columnCountChanged,	this, &TableViewBase::columnCountChanged);
 	connect(_tableModel, &ListModelTableViewBase::rowCountChanged,		this, &TableViewBase::rowCountChanged);
 	connect(_tableModel, &ListModelTableViewBase::variableCountChanged,	this, &TableViewBase::variableCountChanged);
+
+	// The used variables are the column names, if they are variables: the form must know when they change (e.g. the column names of a filtered data entry).
+	auto columnNamesChanged = [this]() { if (_tableModel->areColumnNamesVariables()) emit usedVariablesChanged(); };
+	connect(_tableModel, &QAbstractItemModel::headerDataChanged,			this, [columnNamesChanged](Qt::Orientation orientation) { if (orientation == Qt::Horizontal) columnNamesChanged(); });
+	connect(_tableModel, &QAbstractItemModel::columnsInserted,			this, columnNamesChanged);
+	connect(_tableModel, &QAbstractItemModel::columnsRemoved,			this, columnNamesChanged);
+	connect(_tableModel, &QAbstractItemModel::modelReset,				this, columnNamesChanged);
 }
 
 void TableViewBase::setUp()
@@ -0,0 +1,83 @@
+//
+// Copyright (C) 2013-2018 University of Amsterdam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as
+// published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public
+// License along with this program.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include "termswidthcache.h"
+#include "jasptheme.h"
+#include <QTimer>
+
+QHash<QString, double>	TermsWidthCache::_widths;
+QString					TermsWidthCache::_fingerprint;
+int						TermsWidthCache::_fontVersion = 0;
+bool					TermsWidthCache::_fontChangeHandled = false;
+
+double TermsWidthCache::width(const QString &term)
+{
+	if (_fingerprint.isEmpty())
+		_fingerprint = _fontFingerprint();
+
+	auto it = _widths.constFind(term);
+	if (it != _widths.constEnd())
+		return it.value();
+
+	double result = JaspTheme::fontMetrics().horizontalAdvance(term);
+	_widths.insert(term, result);
+
+	return result;
+}
+
+bool TermsWidthCache::checkFont()
+{
+	QString fingerprint = _fontFingerprint();
+
+	if (fingerprint == _fingerprint)
+		return false;
+
+	_fingerprint = fingerprint;
+	_clear();
+
+	return true;
+}
+
+void TermsWidthCache::fontChanged()
+{
+	// All list controls call this for the same notification: clear the cache only once.
+	if (_fontChangeHandled)
+		return;
+
+	_fontChangeHandled = true;
+	QTimer::singleShot(0, []() { _fontChangeHandled = false; });
+
+	_fingerprint = _fontFingerprint();
+	_clear();
+}
+
+void TermsWidthCache::_clear()
+{
+	_widths.clear();
+	_fontVersion++;
+}
+
+QString TermsWidthCache::_fontFingerprint()
+{
+	// QFontMetricsF does not give access to its font, so compare what matters: the metrics themselves.
+	static const QString probe = "The quick brown fox jumps over the lazy dog 0123456789 _.";
+
+	QFontMetricsF& metrics = JaspTheme::fontMetrics();
+
+	return QString("%1|%2|%3|%4").arg(metrics.height()).arg(metrics.ascent()).arg(metrics.averageCharWidth()).arg(metrics.horizontalAdvance(probe));
+}
@@ -0,0 +1,56 @@
+//
+// Copyright (C) 2013-2018 University of Amsterdam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as
+// published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public
+// License along with this program.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#ifndef TERMSWIDTHCACHE_H
+#define TERMSWIDTHCACHE_H
+
+#include <QString>
+#include <QHash>
+
+///
+/// Cache of the widths of term strings, shared by all list controls.
+/// Measuring a text with QFontMetricsF is not cheap, and the same variable names are displayed in many lists (available & assigned lists of all forms),
+/// so each string is measured only once as long as the interface font stays the same.
+/// The cache is cleared when the font is notified to have changed, and when a fingerprint of the font metrics changes:
+/// the metrics of the theme may be updated only after the notification.
+///
+class TermsWidthCache
+{
+public:
+	static double		width(const QString& term);
+
+	///Clears the cache when the font (or the uiScale) is notified to have changed.
+	static void			fontChanged();
+
+	///Checks whether the font metrics changed since the cache was cleared, and if so clears it again. Returns true in this case.
+	static bool			checkFont();
+
+	///Incremented each time the cache is cleared, so that users of the cache know that their own (derived) values are outdated.
+	static int			fontVersion()	{ return _fontVersion; }
+
+private:
+	static QString		_fontFingerprint();
+	static void			_clear();
+
+	static QHash<QString, double>	_widths;
+	static QString					_fingerprint;
+	static int						_fontVersion;
+	static bool						_fontChangeHandled;
+};
+
+#endif // TERMSWIDTHCACHE_H
@@ -67,6 +67,9 @@ public:
 	QString						text();
 	void						setText(const QString& text);
 
+	Q_INVOKABLE int				syntaxCheckHits()							const				{ return _boundControl ? _boundControl->syntaxCheckHits()	: 0; }
+	Q_INVOKABLE int				syntaxCheckMisses()							const				{ return _boundControl ? _boundControl->syntaxCheckMisses()	: 0; }
+
 public slots:
 	GENERIC_SET_FUNCTION(TextType,			_textType,			textTypeChanged,		JASP::TextType	)
 	GENERIC_SET_FUNCTION(HasScriptError,	_hasScriptError,	hasScriptErrorChanged,	bool			)
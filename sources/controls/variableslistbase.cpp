@@ -253,7 +253,12 @@ void VariablesListBase::moveItems(QList<int> &indexes, ListModelDraggable* targe
 		std::sort(indexes.begin(), indexes.end());
 		if (form()) form()->blockValueChangeSignal(true);
 
+		// The source and the target models may be changed several times during one move:
+		// their dependents get one termsChanged per model when the move is done.
 		ListModelDraggable* sourceModel = _draggableModel;
+		sourceModel->beginTermsTransaction();
+		if (targetModel != sourceModel) targetModel->beginTermsTransaction();
+
 		if (sourceModel == targetModel)
 			sourceModel->moveTerms(indexes, dropItemIndex);
 		else
@@ -308,7 +313,10 @@ void VariablesListBase::moveItems(QList<int> &indexes, ListModelDraggable* targe
 			if (refreshSource)
 				sourceModel->refresh();
 		}
-		
+
+		if (targetModel != sourceModel) targetModel->endTermsTransaction();
+		sourceModel->endTermsTransaction();
+
 		if (form()) form()->blockValueChangeSignal(false);
 	}
 	else
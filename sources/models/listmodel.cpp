@@ -23,19 +23,27 @@
 #include "controls/rowcontrols.h"
 #include "controls/sourceitem.h"
 #include "log.h"
+#include "variableinfocache.h"
 
 ListModel::ListModel(JASPListControl* listView) 
 	: QAbstractTableModel(listView)
 	, _listView(listView)
 {
 	// Connect all apecific signals to a general signal
-	connect(this,	&ListModel::modelReset,				this,	&ListModel::termsChanged);
-	connect(this,	&ListModel::rowsRemoved,			this,	&ListModel::termsChanged);
-	connect(this,	&ListModel::rowsMoved,				this,	&ListModel::termsChanged);
-	connect(this,	&ListModel::rowsInserted,			this,	&ListModel::termsChanged);
+	connect(this,	&ListModel::modelReset,				this,	&ListModel::_notifyTermsChanged);
+	connect(this,	&ListModel::rowsRemoved,			this,	&ListModel::_notifyTermsChanged);
+	connect(this,	&ListModel::rowsMoved,				this,	&ListModel::_notifyTermsChanged);
+	connect(this,	&ListModel::rowsInserted,			this,	&ListModel::_notifyTermsChanged);
 	connect(this,	&ListModel::dataChanged,			this,	&ListModel::dataChangedHandler);
-	connect(this,	&ListModel::namesChanged,			this,	&ListModel::termsChanged);
-	connect(this,	&ListModel::columnTypeChanged,		this,	&ListModel::termsChanged);
+	connect(this,	&ListModel::namesChanged,			this,	&ListModel::_notifyTermsChanged);
+	connect(this,	&ListModel::columnTypeChanged,		this,	&ListModel::_notifyTermsChanged);
+
+	// Keep the search index up to date: inserted & removed rows are handled incrementally, other changes rebuild it at the next search
+	connect(this,	&ListModel::rowsInserted,			this,	[this](const QModelIndex&, int first, int last) { _searchIndex.insertRows(_terms, first, last); });
+	connect(this,	&ListModel::rowsRemoved,			this,	[this](const QModelIndex&, int first, int last) { _searchIndex.removeRows(first, last); });
+	connect(this,	&ListModel::rowsMoved,				this,	[this]() { _searchIndex.invalidate(); });
+	connect(this,	&ListModel::modelReset,				this,	[this]() { _searchIndex.invalidate(); });
+	connect(this,	&ListModel::namesChanged,			this,	[this]() { _searchIndex.invalidate(); });
 }
 
 QHash<int, QByteArray> ListModel::roleNames() const
@@ -243,120 +251,188 @@ QStringList ListModel::termsTypes()
 {
 	QSet<QString> types;
 
-	for (const Term& term : terms())
-	{
-		columnType type = columnType(requestInfo(VariableInfo::VariableType, term.asQString()).toInt());
+	for (columnType type : variableTypes(terms()))
 		if (type != columnType::unknown)
 			types.insert(tq(columnTypeToString(type)));
-	}
 
 	return types.values();
 }
 
+// The column information goes through the cache of the form, so that it is requested only once to the provider for all the controls of the form.
+// Some models have no form (yet): they ask the provider directly.
+columnType ListModel::variableType(const QString &name) const
+{
+	VariableInfoCache* cache = _listView && _listView->form() ? _listView->form()->variableInfoCache() : nullptr;
+
+	return cache ? cache->type(name) : columnType(requestInfo(VariableInfo::VariableType, name).toInt());
+}
+
+std::vector<columnType> ListModel::variableTypes(const QStringList &names) const
+{
+	VariableInfoCache* cache = _listView && _listView->form() ? _listView->form()->variableInfoCache() : nullptr;
+	if (cache)
+		return cache->types(names);
+
+	std::vector<columnType> result;
+	for (const QString& name : names)
+		result.push_back(columnType(requestInfo(VariableInfo::VariableType, name).toInt()));
+
+	return result;
+}
+
+std::vector<columnType> ListModel::variableTypes(const Terms &terms) const
+{
+	VariableInfoCache* cache = _listView && _listView->form() ? _listView->form()->variableInfoCache() : nullptr;
+	if (cache)
+		return cache->types(terms);
+
+	std::vector<columnType> result;
+	for (const Term& term : terms)
+		result.push_back(term.size() == 1 ? columnType(requestInfo(VariableInfo::VariableType, term.asQString()).toInt()) : columnType::unknown);
+
+	return result;
+}
+
+QStringList ListModel::variableLabels(const QString &name) const
+{
+	VariableInfoCache* cache = _listView && _listView->form() ? _listView->form()->variableInfoCache() : nullptr;
+
+	return cache ? cache->labels(name) : requestInfo(VariableInfo::Labels, name).toStringList();
+}
+
+const TermsSearchIndex& ListModel::_getSearchIndex()
+{
+	if (!_searchIndex.isValid() || size_t(_searchIndex.size()) != _terms.size())
+		_searchIndex.build(_terms);
+
+	return _searchIndex;
+}
+
 int ListModel::searchTermWith(QString searchString)
 {
-	int result = -1;
-	const Terms& myTerms = terms();
+	if (searchString.length() == 0 || terms().size() == 0)
+		return -1;
+
 	int startIndex = 0;
-	if (_selectedItems.length() > 0)
+	if (!_selection.isEmpty())
 	{
-		startIndex = _selectedItems.first();
+		startIndex = _selection.first();
 		if (searchString.length() == 1)
 			startIndex++;
 	}
 
-	if (searchString.length() > 0)
-	{
-		QString searchStringLower = searchString.toLower();
-		for (size_t i = 0; i < myTerms.size(); i++)
-		{
-			size_t index = (size_t(startIndex) + i) % myTerms.size();
-			const Term& term = myTerms.at(index);
-			if (term.asQString().toLower().startsWith(searchStringLower))
-			{
-				result = int(index);
-				break;
-			}
-		}
-	}
+	return _getSearchIndex().nextPrefixMatch(searchString, startIndex);
+}
 
-	return result;
+QList<int> ListModel::searchTerms(QString searchString, int mode)
+{
+	if (mode < int(TermsSearchIndex::SearchMode::Prefix) || mode > int(TermsSearchIndex::SearchMode::Fuzzy))
+		mode = int(TermsSearchIndex::SearchMode::Prefix);
+
+	return _getSearchIndex().search(searchString, TermsSearchIndex::SearchMode(mode));
+}
+
+bool ListModel::_isSelectable(int _index) const
+{
+	return data(index(_index, 0), ListModel::SelectableRole).toBool();
 }
 
 void ListModel::_addSelectedItemType(int _index)
 {
 	QString type = data(index(_index, 0), ListModel::ColumnTypeRole).toString();
 	if (!type.isEmpty())
-		_selectedItemsTypes.insert(type);
+		_selectedItemsTypes[type]++;
 }
 
-void ListModel::selectItem(int _index, bool _select)
+void ListModel::_removeSelectedItemType(int _index)
 {
-	bool changed = false;
-	if (_select)
-	{
-		if (data(index(_index, 0), ListModel::SelectableRole).toBool())
-		{
-			int i = 0;
-			for (; i < _selectedItems.length(); i++)
-			{
-				if (_selectedItems[i] == _index)
-					break;
-				else if (_selectedItems[i] > _index)
-				{
-					_selectedItems.insert(i, _index);
-					_addSelectedItemType(_index);
-					changed = true;
-					break;
-				}
-			}
-			if (i == _selectedItems.length())
-			{
-				_selectedItems.append(_index);
-				_addSelectedItemType(_index);
-				changed = true;
-			}
-		}
-	}
-	else
+	QString type = data(index(_index, 0), ListModel::ColumnTypeRole).toString();
+	auto it = _selectedItemsTypes.find(type);
+	if (it != _selectedItemsTypes.end() && --it.value() <= 0)
+		_selectedItemsTypes.erase(it);
+}
+
+void ListModel::_resetSelectedItemsTypes()
+{
+	_selectedItemsTypes.clear();
+	for (int i : _selection.rows())
+		_addSelectedItemType(i);
+}
+
+void ListModel::_applySelectionChange(const RowSelection::Ranges& ranges, bool emitSelectedChange)
+{
+	// The ranges have just been (de)selected: update the types, and emit only one dataChanged per contiguous range.
+	for (const RowSelection::Range& range : ranges)
 	{
-		if (_selectedItems.removeAll(_index) > 0)
+		for (int i = range.first; i <= range.second; i++)
 		{
-			_selectedItemsTypes.clear();
-			for (int i : _selectedItems)
-			{
-				QString type = data(index(i, 0), ListModel::ColumnTypeRole).toString();
-				if (!type.isEmpty())
-					_selectedItemsTypes.insert(type);
-			}
-			changed = true;
+			if (_selection.contains(i))	_addSelectedItemType(i);
+			else						_removeSelectedItemType(i);
 		}
+
+		emit dataChanged(index(range.first, 0), index(range.second, 0), { ListModel::SelectedRole });
 	}
 
-	if (changed)
-	{
-		emit dataChanged(index(_index, 0), index(_index, 0), { ListModel::SelectedRole });
+	if (ranges.size() > 0 && emitSelectedChange)
 		emit selectedItemsChanged();
-	}
 }
 
-void ListModel::clearSelectedItems(bool emitSelectedChange)
+void ListModel::selectItem(int _index, bool _select)
+{
+	if (_select && !_isSelectable(_index))
+		return;
+
+	_applySelectionChange(_selection.set(_index, _select));
+}
+
+void ListModel::selectRange(int first, int last, bool select)
 {
-	QList<int> selected = _selectedItems;
+	if (first > last)
+		std::swap(first, last);
+	last = std::min(last, rowCount() - 1);
 
-	_selectedItems.clear();
+	_applySelectionChange(_selection.setRange(first, last, select, [this](int row) { return _isSelectable(row); }));
+}
+
+void ListModel::invertSelection()
+{
+	_applySelectionChange(_selection.invert(0, rowCount() - 1, [this](int row) { return _isSelectable(row); }));
+}
+
+void ListModel::selectMatching(std::function<bool(int)> predicate)
+{
+	_applySelectionChange(_selection.selectMatching(rowCount(), [&](int row) { return predicate(row) && _isSelectable(row); }));
+}
+
+void ListModel::selectTermsWith(QString searchString, int mode)
+{
+	QList<int> rows = searchTerms(searchString, mode);
+	if (rows.isEmpty())
+		return;
+
+	std::vector<bool> matched(size_t(rowCount()), false);
+	for (int row : rows)
+		if (row < int(matched.size()))
+			matched[size_t(row)] = true;
+
+	selectMatching([&matched](int row) { return matched[size_t(row)]; });
+}
+
+void ListModel::clearSelectedItems(bool emitSelectedChange)
+{
+	RowSelection::Ranges ranges = _selection.clear();
 	_selectedItemsTypes.clear();
 
-	for (int i : selected)
-		emit dataChanged(index(i,0), index(i,0), { ListModel::SelectedRole });
+	for (const RowSelection::Range& range : ranges)
+		emit dataChanged(index(range.first, 0), index(range.second, 0), { ListModel::SelectedRole });
 
-	if (selected.length() > 0 && emitSelectedChange)
+	if (ranges.size() > 0 && emitSelectedChange)
 		emit selectedItemsChanged();
 }
 
 void ListModel::setSelectedItem(int _index)
 {
-	if (_selectedItems.size() == 1 && _selectedItems[0] == _index) return;
+	if (_selection.count() == 1 && _selection.contains(_index)) return;
 
 	clearSelectedItems(false);
 	selectItem(_index, true);
@@ -367,20 +443,7 @@ void ListModel::selectAllItems()
 	int nbTerms = rowCount();
 	if (nbTerms == 0) return;
 
-	_selectedItems.clear();
-	_selectedItemsTypes.clear();
-
-	for (int i = 0; i < nbTerms; i++)
-	{
-		if (data(index(i, 0), ListModel::SelectableRole).toBool())
-		{
-			_selectedItems.append(i);
-			_addSelectedItemType(i);
-		}
-	}
-
-	emit dataChanged(index(0, 0), index(nbTerms - 1, 0), { ListModel::SelectedRole });
-	emit selectedItemsChanged();
+	selectRange(0, nbTerms - 1, true);
 }
 
 void ListModel::sourceTermsReset()
@@ -406,7 +469,7 @@ QVariant ListModel::data(const QModelIndex &index, int role) const
 	case Qt::DisplayRole:
 	case ListModel::NameRole:			return QVariant(myTerms.at(row_t).asQString());
 	case ListModel::SelectableRole:		return !myTerms.at(row_t).asQString().isEmpty();
-	case ListModel::SelectedRole:		return _selectedItems.contains(row);
+	case ListModel::SelectedRole:		return _selection.contains(row);
 	case ListModel::RowComponentRole:
 	{
 		QString term = myTerms.at(row_t).asQString();
@@ -519,13 +582,11 @@ Terms ListModel::filterTerms(const Terms& terms, const QStringList& filters)
 				types.push_back(type);
 		}
 
-		QStringList rightValues;
-		for (const QString& value : values)
-		{
-			columnType type = columnType(requestInfo(VariableInfo::VariableType, value).toInt());
-			if (types.contains(type))
-				rightValues.append(value);
-		}
+		QStringList				rightValues;
+		std::vector<columnType>	valueTypes = variableTypes(values);
+		for (int i = 0; i < values.size(); i++)
+			if (types.contains(valueTypes[size_t(i)]))
+				rightValues.append(values[i]);
 		values = rightValues;
 	}
 
@@ -534,7 +595,7 @@ Terms ListModel::filterTerms(const Terms& terms, const QStringList& filters)
 		QStringList allLabels;
 		for (const QString& value : values)
 		{
-			QStringList labels = requestInfo(VariableInfo::Labels, value).toStringList();
+			QStringList labels = variableLabels(value);
 			if (labels.size() > 0)	allLabels.append(labels);
 			else					allLabels.append(value);
 		}
@@ -587,11 +648,9 @@ int ListModel::sourceColumnTypeChanged(QString name)
 		QModelIndex ind = index(i, 0);
 
 		//keep selected item types up to date
-		if(_selectedItems.contains(i))
+		if(_selection.contains(i))
 		{
-			_selectedItemsTypes.clear();
-			for(int item : _selectedItems)
-				_addSelectedItemType(item);
+			_resetSelectedItemsTypes();
 			emit selectedItemsTypesChanged();
 		}
 
@@ -681,7 +740,29 @@ void ListModel::sourceColumnsChanged(QStringList columns)
 void ListModel::dataChangedHandler(const QModelIndex &, const QModelIndex &, const QVector<int> &roles)
 {
 	if (roles.isEmpty() || roles.size() > 1 || roles[0] != ListModel::SelectedRole)
+	{
+		_searchIndex.invalidate();
+		_notifyTermsChanged();
+	}
+}
+
+void ListModel::_notifyTermsChanged()
+{
+	if (_termsTransactions > 0)	_termsChangedPending = true;
+	else						emit termsChanged();
+}
+
+void ListModel::endTermsTransaction()
+{
+	if (_termsTransactions == 0 || --_termsTransactions > 0) return;
+
+	bool changed = _termsChangedPending;
+	_termsChangedPending = false;
+
+	if (changed)
 		emit termsChanged();
+
+	emit termsTransactionEnded(changed);
 }
 
 void ListModel::_setTerms(const Terms &terms, const Terms& parentTerms)
@@ -715,6 +796,12 @@ void ListModel::_removeTerm(int index)
 	setUpRowControls();
 }
 
+void ListModel::_removeTerms(int index, int count)
+{
+	_terms.remove(size_t(index), size_t(count));
+	setUpRowControls();
+}
+
 void ListModel::_removeTerm(const Term &term)
 {
 	_terms.remove(term);
@@ -733,6 +820,12 @@ void ListModel::_addTerms(const Terms &terms)
 	setUpRowControls();
 }
 
+void ListModel::_insertTerms(int index, const Terms &terms)
+{
+	_terms.insert(index, terms);
+	setUpRowControls();
+}
+
 void ListModel::_addTerm(const QString &term, bool isUnique)
 {
 	_terms.add(term, isUnique);
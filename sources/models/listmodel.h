@@ -24,6 +24,8 @@
 
 #include "common.h"
 #include "terms.h"
+#include "termssearchindex.h"
+#include "rowselection.h"
 #include <json/json.h>
 #include "variableinfo.h"
 
@@ -67,6 +69,7 @@ public:
 			const QString &			name() const;
 			Terms					termsEx(const QStringList& what);
 			const Terms &			terms()														const		{ return _terms;	}
+	virtual bool					rowsAreTerms()												const		{ return true;		} ///< False if the rows of the model do not map one to one on its terms
 	virtual Terms					filterTerms(const Terms& terms, const QStringList& filters);
 			bool					needsSource()												const		{ return _needsSource;			}
 			void					setNeedsSource(bool needs)												{ _needsSource = needs;			}
@@ -86,14 +89,29 @@ public:
 	virtual JASPControl	*			getRowControl(const QString& key, const QString& name)		const;
 	virtual bool					addRowControl(const QString& key, JASPControl* control);
 			QStringList				termsTypes();
+			columnType				variableType(const QString& name)							const;
+			std::vector<columnType>	variableTypes(const QStringList& names)						const;
+			std::vector<columnType>	variableTypes(const Terms& terms)							const;
+			QStringList				variableLabels(const QString& name)							const;
 
 	Q_INVOKABLE int					searchTermWith(QString searchString);
+	Q_INVOKABLE QList<int>			searchTerms(QString searchString, int mode = 0); // mode is a TermsSearchIndex::SearchMode: 0 = prefix, 1 = substring, 2 = fuzzy
 	Q_INVOKABLE void				selectItem(int _index, bool _select);
 	Q_INVOKABLE void				clearSelectedItems(bool emitSelectedChange = true);
 	Q_INVOKABLE void				setSelectedItem(int _index);
 	Q_INVOKABLE void				selectAllItems();
-	Q_INVOKABLE QList<int>			selectedItems()															{ return _selectedItems; }
-    Q_INVOKABLE QList<QString>		selectedItemsTypes()													{ return QList<QString>(_selectedItemsTypes.begin(), _selectedItemsTypes.end()); }
+	Q_INVOKABLE void				selectRange(int first, int last, bool select = true);
+	Q_INVOKABLE void				invertSelection();
+	Q_INVOKABLE void				selectTermsWith(QString searchString, int mode = 0);
+	Q_INVOKABLE QList<int>			selectedItems()															{ return _selection.rows(); }
+	Q_INVOKABLE int					selectedCount()												const		{ return _selection.count(); }
+	Q_INVOKABLE QList<QString>		selectedItemsTypes()													{ return _selectedItemsTypes.keys(); }
+			void					selectMatching(std::function<bool(int row)> predicate);
+
+			///During a terms transaction, termsChanged is emitted only once, when the last transaction ends, and only if the terms have changed.
+			void					beginTermsTransaction()																{ _termsTransactions++; }
+			void					endTermsTransaction();
+			bool					inTermsTransaction()										const		{ return _termsTransactions > 0; }
 
 
 signals:
@@ -106,6 +124,7 @@ signals:
 			void selectedItemsChanged();
 			void oneTermChanged(const QString& oldName, const QString& newName);
 			void selectedItemsTypesChanged();
+			void termsTransactionEnded(bool termsChanged);
 
 public slots:	
 	virtual void sourceTermsReset();
@@ -123,10 +142,12 @@ protected:
 			void	_setTerms(const std::vector<Term>& terms);
 			void	_removeTerms(const Terms& terms);
 			void	_removeTerm(int index);
+			void	_removeTerms(int index, int count);
 			void	_removeTerm(const Term& term);
 			void	_removeLastTerm();
 			void	_addTerms(const Terms& terms);
 			void	_addTerm(const QString& term, bool isUnique = true);
+			void	_insertTerms(int index, const Terms& terms);
 			void	_replaceTerm(int index, const Term& term);
 			void	_connectAllSourcesControls();
 
@@ -136,17 +157,26 @@ protected:
 			QQmlComponent *					_rowComponent			= nullptr;
 			RowControlsValues				_rowControlsValues;
 			QList<BoundControl *>			_rowControlsConnected;
-			QList<int>						_selectedItems;
-			QSet<QString>					_selectedItemsTypes;
+			RowSelection					_selection;
+			QMap<QString, int>				_selectedItemsTypes; // Number of selected items per type
 			QStringList						_columnsUsedForLabels;
 
 private:
+			bool	_isSelectable(int _index)	const;
 			void	_addSelectedItemType(int _index);
+			void	_removeSelectedItemType(int _index);
+			void	_resetSelectedItemsTypes();
+			void	_applySelectionChange(const RowSelection::Ranges& ranges, bool emitSelectedChange = true);
 			void	_initTerms(const Terms &terms, const RowControlsValues& allValuesMap, bool initRowControls = true);
 			void	_connectSourceControls(SourceItem* sourceItem);
+			const TermsSearchIndex&	_getSearchIndex();
+			void	_notifyTermsChanged();
 
 			JASPListControl*				_listView = nullptr;
 			Terms							_terms;
+			TermsSearchIndex				_searchIndex;
+			int								_termsTransactions		= 0;
+			bool							_termsChangedPending	= false;
 
 };
 
@@ -31,6 +31,7 @@ void ListModelAssignedInterface::refresh()
 {
 	bool doRefresh = true;
 	QList<int> toRemove;
+
 	for (int i = 0; i < rowCount(); i++)
 	{
 		QString term = data(index(i, 0)).toString();
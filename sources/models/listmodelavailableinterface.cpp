@@ -72,10 +72,11 @@ void ListModelAvailableInterface::sortItems(SortType sortType)
 	case SortType::SortByType:
 	{
 		QList<QString>				termsList = _allSortedTerms.asQList();
+		std::vector<columnType>		types = variableTypes(termsList);
 		QList<QPair<QString, int> > termsTypeList;
 
-		for (const QString& term : termsList)
-			termsTypeList.push_back(QPair<QString, int>(term, requestInfo(VariableInfo::VariableType, term).toInt()));
+		for (int i = 0; i < termsList.size(); i++)
+			termsTypeList.push_back(QPair<QString, int>(termsList[i], int(types[size_t(i)])));
 
 		std::sort(termsTypeList.begin(), termsTypeList.end(),
 				  [&](const QPair<QString, int>& a, const QPair<QString, int>& b) {
@@ -71,7 +71,7 @@ void ListModelCustomContrasts::getVariablesAndLabels(QStringList& variables, QVe
 			labels = _factors[newVariable];
 		else
 		{
-			columnType colType = columnType(requestInfo(VariableInfo::VariableType, newVariable).toInt());
+			columnType colType = variableType(newVariable);
 			if (colType == columnType::scale)
 			{
 				if (_scaleFactor == 0)
@@ -84,7 +84,7 @@ void ListModelCustomContrasts::getVariablesAndLabels(QStringList& variables, QVe
 				}
 			}
 			else
-				labels = requestInfo(VariableInfo::Labels, newVariable).toStringList();
+				labels = variableLabels(newVariable);
 		}
 
 		QVector<QVector<QVariant> > copyAllLabels = allLabels;
@@ -370,7 +370,7 @@ void ListModelCustomContrasts::scaleFactorChanged()
 	QVector<QString> scaleVariables;
 	for (const QString& variable : _tableTerms.variables)
 	{
-		if (requestInfo(VariableInfo::VariableType, variable).toInt() == int(columnType::scale))
+		if (variableType(variable) == columnType::scale)
 			scaleVariables.push_back(variable);
 	}
 
@@ -20,9 +20,11 @@
 #include "qutils.h"
 #include "log.h"
 #include "controls/factorlevellistbase.h"
+#include <algorithm>
 
 using namespace std;
 
+int ListModelFactorLevels::FactorLevelItem::nextId = 0;
 ListModelFactorLevels::FactorLevelItem ListModelFactorLevels::FactorLevelItem::dummyFactor("", true, false);
 
 ListModelFactorLevels::ListModelFactorLevels(JASPListControl* listView)
@@ -85,7 +87,7 @@ void ListModelFactorLevels::initFactors(const vector<pair<string, vector<string>
 	// Append a virtual factor
 	_items.append(FactorLevelItem(_factorLevelList->factorPlaceHolder(), true, false));
 
-	_setAllLevelsCombinations();
+	_setAllLevelsCombinations(false);
 
 	endResetModel();
 	
@@ -122,48 +124,162 @@ const Terms &ListModelFactorLevels::getLevels() const
 	return _allLevelsCombinations;
 }
 
-void ListModelFactorLevels::_setAllLevelsCombinations()
+void ListModelFactorLevels::_setAllLevelsCombinations(bool incremental)
 {
-	vector<vector<string> > allLevelsCombinations;
 	_setTerms(_getAllFactors()); // _terms get only the factors
-	
-	vector<vector<string> > allLevels;	
-	vector<string> currentLevels;
-	for (const FactorLevelItem& factor: _items)
+
+	vector<CombinationFactor> oldFactors = std::move(_combinationFactors);
+	_combinationFactors = _getCombinationFactors();
+	const vector<CombinationFactor>& newFactors = _combinationFactors;
+
+	// The last factor varies the fastest in the combinations: the stride of a factor is the distance between 2 of its consecutive levels.
+	auto setStrides = [](const vector<CombinationFactor>& factors, vector<int>& strides)
 	{
-		if (factor.isLevel && !factor.isVirtual)
-			currentLevels.push_back(factor.value.toStdString());
-		else if (!currentLevels.empty())
+		int nbCells = factors.empty() ? 0 : 1;
+		strides.assign(factors.size(), 0);
+		for (size_t i = factors.size(); i-- > 0; )
 		{
-			allLevels.push_back(currentLevels);
-			currentLevels.clear();
+			strides[i] = nbCells;
+			nbCells *= int(factors[i].levelIds.size());
 		}
-	}
-	
-	for (const string& level : allLevels[0])
+		return nbCells;
+	};
+
+	vector<int>	oldStrides,
+				newStrides;
+	int			nbOldCells = setStrides(oldFactors, oldStrides),
+				nbNewCells = setStrides(newFactors, newStrides);
+
+	auto levelOf = [](int cell, int stride, size_t nbLevels) { return size_t(cell / stride) % nbLevels; };
+
+	auto makeCell = [&](int cell)
+	{
+		vector<string> components;
+		for (size_t k = 0; k < newFactors.size(); k++)
+			components.push_back(newFactors[k].levels[levelOf(cell, newStrides[k], newFactors[k].levels.size())]);
+		return Term(components);
+	};
+
+	if (!incremental)
 	{
-		vector<string> levelVector {level};
-		allLevelsCombinations.push_back(levelVector);
+		vector<Term> cells;
+		cells.reserve(size_t(nbNewCells));
+		for (int cell = 0; cell < nbNewCells; cell++)
+			cells.push_back(makeCell(cell));
+
+		_allLevelsCombinations.set(cells, false);
+		_levelsRevision++;
+		return;
 	}
-	
-	for (uint i = 1; i < allLevels.size(); i++)
+
+	// Find where the factors and levels are now by their ids, and which levels got another name
+	vector<int>				newFactorOfOld(oldFactors.size(), -1);
+	vector<vector<int>>		newLevelOfOld(oldFactors.size());
+	vector<vector<bool>>	levelRenamed(newFactors.size());
+
+	for (size_t k = 0; k < newFactors.size(); k++)
+		levelRenamed[k].assign(newFactors[k].levelIds.size(), false);
+
+	for (size_t o = 0; o < oldFactors.size(); o++)
 	{
-		const vector<string>& levels = allLevels[i];
-		vector<vector<string> > previousLevelCombinations = allLevelsCombinations; // Copy it
-		allLevelsCombinations.clear();
-		
-		for (uint j = 0; j < previousLevelCombinations.size(); j++)
-		{
-			for (uint k = 0; k < levels.size(); k++)
+		newLevelOfOld[o].assign(oldFactors[o].levelIds.size(), -1);
+
+		for (size_t k = 0; k < newFactors.size(); k++)
+			if (newFactors[k].id == oldFactors[o].id)
 			{
-				vector<string> previousLevels = previousLevelCombinations[j];
-				previousLevels.push_back(levels[k]);
-				allLevelsCombinations.push_back(previousLevels);
+				newFactorOfOld[o] = int(k);
+				for (size_t l = 0; l < oldFactors[o].levelIds.size(); l++)
+				{
+					auto itr = std::find(newFactors[k].levelIds.begin(), newFactors[k].levelIds.end(), oldFactors[o].levelIds[l]);
+					if (itr == newFactors[k].levelIds.end()) continue;
+
+					size_t newLevel = size_t(std::distance(newFactors[k].levelIds.begin(), itr));
+					newLevelOfOld[o][l] = int(newLevel);
+					levelRenamed[k][newLevel] = newFactors[k].levels[newLevel] != oldFactors[o].levels[l];
+				}
 			}
-		}		
 	}
-	
-	_allLevelsCombinations.set(allLevelsCombinations, false);
+
+	// A combination with a removed level is removed. The combinations of a removed factor are kept only for its first level,
+	// and the existing combinations get the first level of a new factor.
+	QVector<int>	newCellIndexes(nbOldCells, -1);
+	vector<int>		oldCellIndexes(size_t(nbNewCells), -1);
+	bool			sameCells = nbOldCells == nbNewCells;
+
+	for (int cell = 0; cell < nbOldCells; cell++)
+	{
+		int newCell = 0;
+		for (size_t o = 0; o < oldFactors.size() && newCell >= 0; o++)
+		{
+			size_t level = levelOf(cell, oldStrides[o], oldFactors[o].levelIds.size());
+
+			if (newFactorOfOld[o] == -1)			{ if (level != 0) newCell = -1; }
+			else if (newLevelOfOld[o][level] == -1)	newCell = -1;
+			else									newCell += newLevelOfOld[o][level] * newStrides[size_t(newFactorOfOld[o])];
+		}
+
+		newCellIndexes[cell] = newCell;
+		if (newCell >= 0)	oldCellIndexes[size_t(newCell)] = cell;
+		sameCells = sameCells && newCell == cell;
+	}
+
+	// An existing combination can be kept as it is only if the factors are the same: otherwise its components change.
+	bool sameFactors = newFactors.size() == oldFactors.size() && std::find(newFactorOfOld.begin(), newFactorOfOld.end(), -1) == newFactorOfOld.end();
+
+	// Only the new combinations and the ones with a renamed level (or other factors) are made again
+	vector<Term>	cells;
+	QVector<int>	changedCells;
+	cells.reserve(size_t(nbNewCells));
+
+	for (int cell = 0; cell < nbNewCells; cell++)
+	{
+		int		oldCell = oldCellIndexes[size_t(cell)];
+		bool	renamed = oldCell >= 0 && !sameFactors;
+
+		for (size_t k = 0; k < newFactors.size() && oldCell >= 0 && !renamed; k++)
+			renamed = levelRenamed[k][levelOf(cell, newStrides[k], levelRenamed[k].size())];
+
+		if (oldCell >= 0 && !renamed)	cells.push_back(_allLevelsCombinations.at(size_t(oldCell)));
+		else							cells.push_back(makeCell(cell));
+
+		if (renamed)					changedCells.push_back(cell);
+	}
+
+	if (sameCells && changedCells.isEmpty())
+		return; // For example a factor got another name: the combinations stay the same
+
+	_allLevelsCombinations.set(cells, false);
+	_levelsRevision++;
+
+	emit levelsChanged(newCellIndexes, changedCells);
+}
+
+vector<ListModelFactorLevels::CombinationFactor> ListModelFactorLevels::_getCombinationFactors() const
+{
+	vector<CombinationFactor>	result;
+	CombinationFactor			current;
+
+	for (const FactorLevelItem& item: _items)
+	{
+		if (!item.isLevel)
+		{
+			if (!current.levelIds.empty())
+				result.push_back(current);
+
+			current		= CombinationFactor();
+			current.id	= item.id;
+		}
+		else if (!item.isVirtual)
+		{
+			current.levelIds.push_back(item.id);
+			current.levels.push_back(fq(item.value));
+		}
+	}
+
+	if (!current.levelIds.empty())
+		result.push_back(current);
+
+	return result;
 }
 
 QStringList ListModelFactorLevels::_getAllFactors() const
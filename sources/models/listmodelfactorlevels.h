@@ -36,7 +36,12 @@ public:
 	void initFactors(const std::vector<std::pair<std::string, std::vector<std::string> > > &factors);
 	std::vector<std::pair<std::string, std::vector<std::string> > > getFactors() const;
 	const Terms& getLevels() const;
+	int levelsRevision() const { return _levelsRevision; }
 
+signals:
+	///Emitted when the levels combinations are updated after an edit: newCellIndexes gives for each old combination its new index (-1 if it is removed),
+	///and changedCells the new indexes of the kept combinations whose labels changed. The combinations not in newCellIndexes are inserted.
+	void levelsChanged(const QVector<int>& newCellIndexes, const QVector<int>& changedCells);
 	
 public slots:
 	void itemChanged(int row, QVariant value);
@@ -50,11 +55,12 @@ protected:
 		QString				value;
 		bool				isVirtual;
 		bool				isLevel;
+		int					id;			///< Identifies the item when its value changes
 
 		FactorLevelItem(const QString& _value, bool _isVirtual, bool _isLevel) :
-			value(_value), isVirtual(_isVirtual), isLevel(_isLevel) {}
+			value(_value), isVirtual(_isVirtual), isLevel(_isLevel), id(nextId++) {}
 
-		FactorLevelItem(const FactorLevelItem& item) : value(item.value), isVirtual(item.isVirtual), isLevel(item.isLevel) {}
+		FactorLevelItem(const FactorLevelItem& item) : value(item.value), isVirtual(item.isVirtual), isLevel(item.isLevel), id(item.id) {}
 
         bool operator==(const FactorLevelItem& item) const
         {
@@ -68,16 +74,28 @@ protected:
 		}
 
 		static FactorLevelItem dummyFactor;
+		static int nextId;
 	};
 
-	QList<FactorLevelItem>	_items;
-	Terms					_allLevelsCombinations;
+	///A factor with at least one level, as used in the levels combinations
+	struct CombinationFactor
+	{
+		int							id = -1;
+		std::vector<int>			levelIds;
+		std::vector<std::string>	levels;
+	};
+
+	QList<FactorLevelItem>			_items;
+	Terms							_allLevelsCombinations;
+	std::vector<CombinationFactor>	_combinationFactors;
+	int								_levelsRevision = 0;
 
 	QStringList			_getAllFactors()													const;
 	QString				_giveUniqueValue(const FactorLevelItem& item, const QString value)	const;
 	bool				_isDeletable(const FactorLevelItem& item)							const;
 	FactorLevelItem&	_getFactor(const FactorLevelItem& item)								const;
-	void				_setAllLevelsCombinations();
+	void				_setAllLevelsCombinations(bool incremental = true);
+	std::vector<CombinationFactor>	_getCombinationFactors()								const;
 	bool				_removeItem(int row);
 };
 
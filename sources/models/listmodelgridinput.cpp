@@ -18,6 +18,7 @@
 
 #include "listmodelgridinput.h"
 #include "controls/tableviewbase.h"
+#include <algorithm>
 
 ListModelGridInput::ListModelGridInput(TableViewBase *parent) : ListModelTableViewBase(parent)
 {
@@ -36,6 +37,9 @@ void ListModelGridInput::initTableTerms(const ListModelTableViewBase::TableTerms
 	for (const auto & column : terms.values)
 		if (column.length() > _rowCount)		_rowCount = column.length();
 
+	// The values do not come from the source: the next read compares them cell by cell.
+	_sourceRowsKnown = false;
+
 	ListModelTableViewBase::initTableTerms(terms);
 }
 
@@ -59,49 +63,233 @@ void ListModelGridInput::_readSource()
 	if (_tableView->maxRow() >= 0 && nbRows > _tableView->maxRow())				nbRows = _tableView->maxRow();
 	if (_tableView->maxColumn() >= 0 && nbColumns > _tableView->maxColumn())	nbColumns = _tableView->maxColumn();
 
-	if (nbRows == _rowCount && nbColumns == _tableTerms.colNames.length())
+	SourceRows sourceRows;
+	for (const Term& term : terms)
+	{
+		if (sourceRows.length() >= nbRows) break;
+		sourceRows.append(term.components());
+	}
+
+	int oldRowCount		= _rowCount,
+		oldColumnCount	= columnCount();
+
+	if (!_sourceRowsKnown)
 	{
-		// Apparently only some valuee has been changed. Just emit a dataChanged in this case
-		for (int colNb = 0; colNb < nbColumns; colNb++)
+		if (nbRows == _rowCount && nbColumns == _tableTerms.colNames.length())	_syncCells(sourceRows);	// Apparently only some values have been changed
+		else																	_resetFromSource(sourceRows, nbRows, nbColumns);
+	}
+	else
+	{
+		QVector<bool> kept;
+
+		if (!_keptRows(sourceRows, kept))
+			_resetFromSource(sourceRows, nbRows, nbColumns);
+		else
 		{
-			QVector<QVariant> column;
-			for (int rowNb = 0; rowNb < nbRows; rowNb++)
-			{
-				const Term& term = int(terms.size()) > rowNb ? terms.at(size_t(rowNb)) : Term(QStringList());
-				const QStringList& rowValues = term.components();
-				QVariant value = rowValues.length() > colNb ? rowValues.at(colNb) : _tableView->defaultValue();
-				if (value != _tableTerms.values[colNb][rowNb])
-				{
-					_tableTerms.values[colNb][rowNb] = value;
-					QModelIndex ind = index(rowNb, colNb);
-					emit dataChanged(ind, ind, {Qt::DisplayRole});
-				}
-			}
+			_syncColumns(nbColumns);
+			_syncRows(sourceRows, kept);
+
+			// The other rows, up to minRow, have no source term.
+			int nbSourceRows	= int(sourceRows.length()),
+				nbFillerRows	= nbRows - nbSourceRows,
+				oldNbFillerRows	= _rowCount - nbSourceRows;
+
+			if (oldNbFillerRows > nbFillerRows)			_removeRows(nbSourceRows + nbFillerRows, oldNbFillerRows - nbFillerRows);
+			else if (oldNbFillerRows < nbFillerRows)	_insertRows(_rowCount, SourceRows(nbFillerRows - oldNbFillerRows));
 		}
 	}
-	else
+
+	_sourceRows			= sourceRows;
+	_sourceRowsKnown	= true;
+
+	if (_rowCount != oldRowCount)			emit rowCountChanged();
+	if (columnCount() != oldColumnCount)	emit columnCountChanged();
+}
+
+QVariant ListModelGridInput::_cellValue(const QStringList &sourceRow, int colNb) const
+{
+	return sourceRow.length() > colNb ? sourceRow.at(colNb) : _tableView->defaultValue();
+}
+
+void ListModelGridInput::_resetFromSource(const SourceRows &sourceRows, int nbRows, int nbColumns)
+{
+	beginResetModel();
+
+	_tableTerms.clear();
+
+	for (int colNb = 0; colNb < nbColumns; colNb++)
 	{
-		beginResetModel();
+		QVector<QVariant> column;
+		for (int rowNb = 0; rowNb < nbRows; rowNb++)
+			column.append(_cellValue(rowNb < sourceRows.length() ? sourceRows[rowNb] : QStringList(), colNb));
+
+		_tableTerms.values.append(column);
+		_tableTerms.colNames.append(QString::number(colNb));
+	}
 
-		_tableTerms.clear();
+	_rowCount = nbRows;
+	_resetRowNames();
 
-		for (int colNb = 0; colNb < nbColumns; colNb++)
+	endResetModel();
+}
+
+void ListModelGridInput::_syncCells(const SourceRows &sourceRows)
+{
+	// Only one dataChanged is emitted, for the range of all the changed cells.
+	int firstRow = _rowCount, lastRow = -1, firstCol = columnCount(), lastCol = -1;
+
+	for (int colNb = 0; colNb < columnCount(); colNb++)
+		for (int rowNb = 0; rowNb < _rowCount; rowNb++)
 		{
-			QVector<QVariant> column;
-			for (size_t rowNb = 0; rowNb < size_t(nbRows); rowNb++)
+			QVariant value = _cellValue(rowNb < sourceRows.length() ? sourceRows[rowNb] : QStringList(), colNb);
+			if (value != _tableTerms.values[colNb][rowNb])
 			{
-				const Term& term = terms.size() > rowNb ? terms.at(rowNb) : Term(QStringList());
-				const QStringList& rowValues = term.components();
-				column.append(rowValues.length() > colNb ? rowValues.at(colNb) : _tableView->defaultValue());
+				_tableTerms.values[colNb][rowNb] = value;
+				firstRow	= std::min(firstRow, rowNb);
+				lastRow		= std::max(lastRow, rowNb);
+				firstCol	= std::min(firstCol, colNb);
+				lastCol		= std::max(lastCol, colNb);
 			}
+		}
+
+	if (lastRow >= 0)
+		emit dataChanged(index(firstRow, firstCol), index(lastRow, lastCol), {Qt::DisplayRole});
+}
+
+void ListModelGridInput::_syncColumns(int nbColumns)
+{
+	int oldNbColumns = columnCount();
+
+	if (nbColumns < oldNbColumns)
+	{
+		beginRemoveColumns(QModelIndex(), nbColumns, oldNbColumns - 1);
+		_tableTerms.values.resize(nbColumns);
+		_tableTerms.colNames = _tableTerms.colNames.mid(0, nbColumns);
+		endRemoveColumns();
+	}
+	else if (nbColumns > oldNbColumns)
+	{
+		beginInsertColumns(QModelIndex(), oldNbColumns, nbColumns - 1);
+		for (int colNb = oldNbColumns; colNb < nbColumns; colNb++)
+		{
+			QVector<QVariant> column;
+			for (int rowNb = 0; rowNb < _rowCount; rowNb++)
+				column.append(_cellValue(rowNb < _sourceRows.length() ? _sourceRows[rowNb] : QStringList(), colNb));
+
 			_tableTerms.values.append(column);
 			_tableTerms.colNames.append(QString::number(colNb));
 		}
+		endInsertColumns();
+	}
+}
 
-		for (int i = 0; i < _rowCount; i++)
-			_tableTerms.rowNames.append(_tableView->rowNames().count() > i ? _tableView->rowNames()[i] : QString::number(i));
-		_rowCount = nbRows;
+bool ListModelGridInput::_keptRows(const SourceRows &sourceRows, QVector<bool> &kept) const
+{
+	QHash<QStringList, int> available;
+	for (const QStringList& sourceRow : sourceRows)
+		available[sourceRow]++;
 
-		endResetModel();
+	SourceRows keptRows;
+	for (const QStringList& oldRow : _sourceRows)
+	{
+		bool isKept = available.value(oldRow) > 0;
+		if (isKept)
+		{
+			available[oldRow]--;
+			keptRows.append(oldRow);
+		}
+		kept.append(isKept);
 	}
+
+	// The kept rows must be in the same order in the new source, otherwise the other rows cannot be just inserted or removed.
+	int keptIndex = 0;
+	for (const QStringList& sourceRow : sourceRows)
+		if (keptIndex < keptRows.length() && sourceRow == keptRows[keptIndex])
+			keptIndex++;
+
+	return keptIndex == keptRows.length();
+}
+
+void ListModelGridInput::_syncRows(const SourceRows &sourceRows, const QVector<bool> &kept)
+{
+	const SourceRows& oldRows = _sourceRows;
+
+	int row = 0, oldIndex = 0, newIndex = 0, nbOldRows = int(oldRows.length()), nbNewRows = int(sourceRows.length());
+	while (oldIndex < nbOldRows || newIndex < nbNewRows)
+	{
+		if (oldIndex < nbOldRows && kept[oldIndex] && newIndex < nbNewRows && oldRows[oldIndex] == sourceRows[newIndex])
+		{
+			oldIndex++;
+			newIndex++;
+			row++;
+			continue;
+		}
+
+		int removed = 0, inserted = 0;
+		while (oldIndex + removed < nbOldRows && !kept[oldIndex + removed])
+			removed++;
+
+		int nextKept = oldIndex + removed;
+		while (newIndex + inserted < nbNewRows && !(nextKept < nbOldRows && sourceRows[newIndex + inserted] == oldRows[nextKept]))
+			inserted++;
+
+		if (removed == 0 && inserted == 0)
+			break;
+
+		// Rows whose term is replaced by another one are just changed.
+		int replaced = std::min(removed, inserted);
+		if (replaced > 0)					_setRows(row, sourceRows.mid(newIndex, replaced));
+		if (removed > replaced)				_removeRows(row + replaced, removed - replaced);
+		else if (inserted > replaced)		_insertRows(row + replaced, sourceRows.mid(newIndex + replaced, inserted - replaced));
+
+		oldIndex	+= removed;
+		newIndex	+= inserted;
+		row			+= inserted;
+	}
+}
+
+void ListModelGridInput::_setRows(int row, const SourceRows &rows)
+{
+	for (int colNb = 0; colNb < columnCount(); colNb++)
+		for (int i = 0; i < rows.length(); i++)
+			_tableTerms.values[colNb][row + i] = _cellValue(rows[i], colNb);
+
+	if (columnCount() > 0)
+		emit dataChanged(index(row, 0), index(row + rows.length() - 1, columnCount() - 1), {Qt::DisplayRole});
+}
+
+void ListModelGridInput::_insertRows(int row, const SourceRows &rows)
+{
+	beginInsertRows(QModelIndex(), row, row + rows.length() - 1);
+
+	for (int colNb = 0; colNb < columnCount(); colNb++)
+		for (int i = 0; i < rows.length(); i++)
+			_tableTerms.values[colNb].insert(row + i, _cellValue(rows[i], colNb));
+
+	_rowCount += rows.length();
+	_resetRowNames();
+
+	endInsertRows();
+}
+
+void ListModelGridInput::_removeRows(int row, int count)
+{
+	beginRemoveRows(QModelIndex(), row, row + count - 1);
+
+	for (QVector<QVariant>& column : _tableTerms.values)
+		column.remove(row, count);
+
+	_rowCount -= count;
+	_resetRowNames();
+
+	endRemoveRows();
+}
+
+void ListModelGridInput::_resetRowNames()
+{
+	const QStringList& rowNames = _tableView->rowNames();
+
+	_tableTerms.rowNames.clear();
+	for (int i = 0; i < _rowCount; i++)
+		_tableTerms.rowNames.append(rowNames.count() > i ? rowNames[i] : QString::number(i));
 }
@@ -37,9 +37,25 @@ public:
 	void	sourceTermsReset()												override;
 
 private:
-	void	_readSource();
-
-	int		_rowCount = 0;
+	typedef QVector<QStringList> SourceRows;
+
+	void		_readSource();
+	void		_resetFromSource(const SourceRows& sourceRows, int nbRows, int nbColumns);
+	void		_syncCells(const SourceRows& sourceRows);
+	void		_syncColumns(int nbColumns);
+	bool		_keptRows(const SourceRows& sourceRows, QVector<bool>& kept)		const;
+	void		_syncRows(const SourceRows& sourceRows, const QVector<bool>& kept);
+	void		_setRows(int row, const SourceRows& rows);
+	void		_insertRows(int row, const SourceRows& rows);
+	void		_removeRows(int row, int count);
+	void		_resetRowNames();
+	QVariant	_cellValue(const QStringList& sourceRow, int colNb)				const;
+
+	int			_rowCount			= 0;
+	///Components of the source term of each of the first rows: the other rows (up to minRow) have no source term.
+	///A row is identified by its term: when the source changes, only the rows of the terms that were added or removed are inserted, removed or replaced.
+	SourceRows	_sourceRows;
+	bool		_sourceRowsKnown	= false;
 
 };
 
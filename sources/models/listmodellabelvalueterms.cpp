@@ -24,6 +24,18 @@ ListModelLabelValueTerms::ListModelLabelValueTerms(JASPListControl* listView, co
 	: ListModelAvailableInterface(listView)
 {
 	_setLabelValues(values);
+
+	// Not on termsChanged: during a terms transaction it comes only at the end, and the indexes must not lag behind the terms.
+	connect(this, &ListModel::modelReset,	this, [this]() { _indexesValid = false; });
+	connect(this, &ListModel::rowsInserted,	this, [this]() { _indexesValid = false; });
+	connect(this, &ListModel::rowsRemoved,	this, [this]() { _indexesValid = false; });
+	connect(this, &ListModel::rowsMoved,	this, [this]() { _indexesValid = false; });
+	connect(this, &ListModel::dataChanged,	this, [this](const QModelIndex &, const QModelIndex &, const QVector<int> &roles)
+	{
+		// A selection change does not change the labels or values: keep the indexes, as ListModel::dataChangedHandler does.
+		if (roles.isEmpty() || roles.size() > 1 || roles[0] != ListModel::SelectedRole)
+			_indexesValid = false;
+	});
 }
 
 QVariant ListModelLabelValueTerms::data(const QModelIndex &index, int role) const
@@ -83,18 +95,61 @@ QString ListModelLabelValueTerms::getLabel(const QString &value) const
 	return _valueToLabelMap.contains(value) ? _valueToLabelMap[value] : value;
 }
 
+void ListModelLabelValueTerms::_buildIndexes() const
+{
+	if (_indexesValid && _indexedRows == terms().size())
+		return;
+
+	_valueToIndex.clear();
+	_lowerValueToIndex.clear();
+	_labelToIndex.clear();
+
+	int row = 0;
+	for (const Term& term : terms())
+	{
+		QString label = term.asQString(),
+				value = getValue(label);
+
+		// Keep the first row, as a linear search would do
+		_labelToIndex.insert(label, _labelToIndex.value(label, row));
+		_valueToIndex.insert(value, _valueToIndex.value(value, row));
+		_lowerValueToIndex.insert(value.toLower(), _lowerValueToIndex.value(value.toLower(), row));
+		row++;
+	}
+
+	_indexedRows	= terms().size();
+	_indexesValid	= true;
+}
+
 int ListModelLabelValueTerms::getIndexOfValue(const QString &value) const
 {
-	return terms().indexOf(getLabel(value));
+	_buildIndexes();
+
+	auto it = _valueToIndex.find(value);
+	if (it != _valueToIndex.end())
+		return it.value();
+
+	// A value without label is also looked up as label (see getLabel)
+	return _valueToLabelMap.contains(value) ? -1 : _labelToIndex.value(value, -1);
+}
+
+int ListModelLabelValueTerms::getIndexOfValueCaseInsensitive(const QString &value) const
+{
+	_buildIndexes();
+
+	return _lowerValueToIndex.value(value.toLower(), -1);
 }
 
 int ListModelLabelValueTerms::getIndexOfLabel(const QString &label) const
 {
-	return terms().indexOf(label);
+	_buildIndexes();
+
+	return _labelToIndex.value(label, -1);
 }
 
 void ListModelLabelValueTerms::_setLabelValues(const JASPListControl::LabelValueMap &labelvalues)
 {
+	_indexesValid = false;
 	_valueToLabelMap.clear();
 	_labelToValueMap.clear();
 	Terms newTerms;
@@ -146,6 +201,7 @@ void ListModelLabelValueTerms::sourceNamesChanged(QMap<QString, QString> map)
 		QSet<int> indexes = newTerms.replaceVariableName(oldName.toStdString(), newName.toStdString());
 		if (indexes.size() > 0)
 		{
+			_indexesValid = false;
 			_setTerms(newTerms);
 			QString oldValue = _labelToValueMap[oldName];
 			_labelToValueMap.remove(oldName);
@@ -19,6 +19,7 @@
 #ifndef LISTMODELLABELVALUETERMS_H
 #define LISTMODELLABELVALUETERMS_H
 
+#include <QHash>
 #include "controls/jasplistcontrol.h"
 #include "listmodelavailableinterface.h"
 
@@ -35,6 +36,7 @@ public:
 	QString						getValue(const QString& label)								const;
 	QString						getLabel(const QString& value)								const;
 	int							getIndexOfValue(const QString& value)						const;
+	int							getIndexOfValueCaseInsensitive(const QString& value)		const;
 	int							getIndexOfLabel(const QString& label)						const;
 
 	void						setLabelValuesFromSource();
@@ -44,10 +46,18 @@ public slots:
 
 protected:
 	void						_setLabelValues(const JASPListControl::LabelValueMap& values);
+	void						_buildIndexes()													const;
 
 	QMap<QString, QString>		_valueToLabelMap;
 	QMap<QString, QString>		_labelToValueMap;
 
+	///Row of the first term with some value, lower-cased value or label: they are rebuilt (at the next lookup) when the terms change.
+	mutable QHash<QString, int>	_valueToIndex,
+								_lowerValueToIndex,
+								_labelToIndex;
+	mutable size_t				_indexedRows				= 0;
+	mutable bool				_indexesValid				= false;
+
 };
 
 #endif // LISTMODELLABELVALUETERMS_H
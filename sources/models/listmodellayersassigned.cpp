@@ -20,12 +20,15 @@
 #include "boundcontrols/boundcontrollayers.h"
 #include "qutils.h"
 
+#include <algorithm>
+
 using namespace std;
 
 
 ListModelLayersAssigned::ListModelLayersAssigned(JASPListControl* listView)
 	: ListModelAssignedInterface(listView)
 {
+	_setLayerStarts();
 }
 
 void ListModelLayersAssigned::initLayers(const std::vector<std::vector<std::string> >& allVariables)
@@ -69,24 +72,32 @@ std::vector<std::pair<string, std::vector<string> > > ListModelLayersAssigned::g
 
 int ListModelLayersAssigned::_getLayer(int index, int& indexInLayer, bool inclusive) const
 {
-	int layer = 0;
-	int layerIndex = 0; // Layer 1
 	indexInLayer = -1;
-	
-	if (inclusive) index--;
-	while ((layer < _variables.length()) && (layerIndex + _variables[layer].length() < index))
-	{
-		layerIndex += _variables[layer].length() + 1;
-		layer++;
-	}
-	
-	if (inclusive) index++;
+
+	// The layer of a row is the first one whose next layer starts after this row
+	// If inclusive, the row just after the last variable of a layer belongs still to this layer.
+	int searchedIndex	= inclusive ? index - 1 : index,
+		layer			= int(std::upper_bound(_layerStarts.begin() + 1, _layerStarts.end(), searchedIndex) - (_layerStarts.begin() + 1));
+
 	if (layer < _variables.length())
-		indexInLayer = index - layerIndex - 1;
+		indexInLayer = index - _layerStarts[layer] - 1;
 		
 	return layer;
 }
 
+void ListModelLayersAssigned::_setLayerStarts()
+{
+	_layerStarts.resize(_variables.length() + 1);
+
+	int row = 0;
+	for (int layer = 0; layer < _variables.length(); layer++)
+	{
+		_layerStarts[layer] = row;
+		row += _variables[layer].length() + 1;
+	}
+	_layerStarts[_variables.length()] = row;
+}
+
 void ListModelLayersAssigned::_setTerms()
 {
 	Terms newTerms;
@@ -101,9 +112,104 @@ void ListModelLayersAssigned::_setTerms()
 
 	newTerms.add(tr("Layer %1").arg(layer));
 
+	_setLayerStarts();
 	ListModel::_setTerms(newTerms);
 }
 
+void ListModelLayersAssigned::_insertVariables(int layer, int indexInLayer, const QStringList &variables)
+{
+	if (variables.isEmpty()) return;
+
+	if (layer >= _variables.length())
+	{
+		// The virtual layer gets the variables: add a new virtual layer after it
+		int row = rowCount();
+
+		beginInsertRows(QModelIndex(), row, row);
+		_variables.push_back(QList<QString>());
+		layer = _variables.length() - 1;
+		_insertTerms(row, Terms(QList<QString>{ tr("Layer %1").arg(_variables.length() + 1) }));
+		_setLayerStarts();
+		endInsertRows();
+	}
+
+	indexInLayer = std::min(std::max(indexInLayer, 0), int(_variables[layer].length()));
+
+	int row = _layerStarts[layer] + 1 + indexInLayer;
+
+	beginInsertRows(QModelIndex(), row, row + variables.length() - 1);
+	for (int i = 0; i < variables.length(); i++)
+		_variables[layer].insert(indexInLayer + i, variables[i]);
+	Terms variableTerms;
+	for (const QString& variable : variables)
+		variableTerms.add(Term(variable), false);
+	_insertTerms(row, variableTerms);
+	_setLayerStarts();
+	endInsertRows();
+}
+
+void ListModelLayersAssigned::_removeVariables(const QList<int> &sortedIndexes)
+{
+	// The indexes are sorted from the last to the first: the consecutive rows of a layer are removed at once.
+	for (int i = 0; i < sortedIndexes.length(); i++)
+	{
+		int indexInLayer	= -1,
+			last			= sortedIndexes[i],
+			layer			= _getLayer(last, indexInLayer);
+
+		if (layer >= _variables.length() || indexInLayer < 0 || indexInLayer >= _variables[layer].length())
+			continue;
+
+		int first = last, firstIndexInLayer = indexInLayer;
+		while (i + 1 < sortedIndexes.length() && sortedIndexes[i + 1] == first - 1 && firstIndexInLayer > 0)
+		{
+			first--;
+			firstIndexInLayer--;
+			i++;
+		}
+
+		beginRemoveRows(QModelIndex(), first, last);
+		for (int row = last; row >= first; row--)
+		{
+			_variables[layer].removeAt(firstIndexInLayer + row - first);
+			_removeTerm(row);
+		}
+		_setLayerStarts();
+		endRemoveRows();
+	}
+}
+
+void ListModelLayersAssigned::_removeEmptyLayers()
+{
+	for (int layer = _variables.length() - 1; layer >= 0; layer--)
+		if (_variables[layer].length() == 0)
+		{
+			int row = _layerStarts[layer];
+
+			beginRemoveRows(QModelIndex(), row, row);
+			_variables.removeAt(layer);
+			_removeTerm(row);
+			_setLayerStarts();
+			endRemoveRows();
+		}
+}
+
+void ListModelLayersAssigned::_updateLayerNames()
+{
+	// When layers are removed, the names of the next layers change
+	for (int layer = 0; layer < _layerStarts.length(); layer++)
+	{
+		int		row		= _layerStarts[layer];
+		QString name	= tr("Layer %1").arg(layer + 1);
+
+		if (size_t(row) < terms().size() && terms().at(size_t(row)).asQString() != name)
+		{
+			_replaceTerm(row, Term(name));
+			emit dataChanged(index(row, 0), index(row, 0));
+		}
+	}
+}
+
 Terms ListModelLayersAssigned::termsFromIndexes(const QList<int> &indexes) const
 {
 	Terms terms;
@@ -125,66 +231,38 @@ Terms ListModelLayersAssigned::termsFromIndexes(const QList<int> &indexes) const
 Terms ListModelLayersAssigned::addTerms(const Terms& terms, int dropItemIndex, const RowControlsValues&)
 {
 	Terms result;
-	beginResetModel();
 	
 	int layer = _variables.length();
 	int indexInLayer = 0;
 	if (dropItemIndex >= 0)
 		layer = _getLayer(dropItemIndex, indexInLayer, true);
 	
-	if (layer >= _variables.length())	
-	{
-		_variables.push_back(QList<QString>());
-		layer = _variables.length() - 1;
-		indexInLayer = 0;
-	}
-	
-	if (indexInLayer < 0)
-		indexInLayer = 0;
-	
+	// Each term is inserted at the drop place, so they end up in the reverse order
+	QStringList variables;
 	for (const Term& term : terms)
-		_variables[layer].insert(indexInLayer, term.asQString());
+		variables.prepend(term.asQString());
 
-	_setTerms();
-	
-	endResetModel();
+	_insertVariables(layer, indexInLayer, variables);
 	
 	return result;
 }
 
 void ListModelLayersAssigned::moveTerms(const QList<int> &indexes, int dropItemIndex)
 {	
-	beginResetModel();
-	
 	int layerDrop = _variables.length();
 	int indexInLayerDrop = 0;
 	if (dropItemIndex >= 0)
 		layerDrop = _getLayer(dropItemIndex, indexInLayerDrop, true);
 	
-	if (layerDrop >= _variables.length())	
-	{
-		_variables.push_back(QList<QString>());
-		layerDrop = _variables.length() - 1;
-		indexInLayerDrop = 0;
-	}
-	
 	if (indexInLayerDrop < 0)
 		indexInLayerDrop = 0;
 	
 	QList<QString> movedVariables;
 	QList<int> sortedIndexes = indexes;
 	std::sort(sortedIndexes.begin(), sortedIndexes.end(), std::greater<int>());
+	sortedIndexes.erase(std::unique(sortedIndexes.begin(), sortedIndexes.end()), sortedIndexes.end());
 	// Store first the variables that must be moved, before removing them in the _variables list:
 	// removing the items in the _variables list will change the indexes
-	for (int index : sortedIndexes)
-	{
-		int indexInLayer = 0;
-		int layer = _getLayer(index, indexInLayer);
-		
-		if (layer < _variables.length() && indexInLayer >= 0 && indexInLayer < _variables[layer].length())
-			movedVariables.push_back(_variables[layer][indexInLayer]);
-	}
-	
 	for (int index : sortedIndexes)
 	{
 		int indexInLayer = 0;
@@ -192,54 +270,32 @@ void ListModelLayersAssigned::moveTerms(const QList<int> &indexes, int dropItemI
 		
 		if (layer < _variables.length() && indexInLayer >= 0 && indexInLayer < _variables[layer].length())
 		{
+			movedVariables.prepend(_variables[layer][indexInLayer]);
 			if (layer == layerDrop && indexInLayer < indexInLayerDrop)
 				indexInLayerDrop--;
-			_variables[layer].removeAt(indexInLayer);
 		}
 	}
-	
-	for (const QString& variable : movedVariables)
-		_variables[layerDrop].insert(indexInLayerDrop, variable);
-	
-	for (int i = _variables.length() - 1; i >= 0; i--)
-	{
-		if (_variables[i].length() == 0)
-			_variables.removeAt(i);
-	}
 
-	_setTerms();
-	
-	endResetModel();	
+	clearSelectedItems();
+
+	// The empty layers are removed only once the variables are inserted, so that layerDrop stays valid.
+	_removeVariables(sortedIndexes);
+	_insertVariables(layerDrop, indexInLayerDrop, movedVariables);
+	_removeEmptyLayers();
+	_updateLayerNames();
 }
 
 void ListModelLayersAssigned::removeTerms(const QList<int> &indexes)
 {
-	beginResetModel();
-	
 	QList<int> sortedIndexes = indexes;
 	std::sort(sortedIndexes.begin(), sortedIndexes.end(), std::greater<int>());
+	sortedIndexes.erase(std::unique(sortedIndexes.begin(), sortedIndexes.end()), sortedIndexes.end());
 
+	clearSelectedItems();
 
-	for (int index : sortedIndexes)
-	{
-		int layer = _variables.length();
-		int indexInLayer = 0;
-
-		layer = _getLayer(index, indexInLayer);
-		if (layer >= 0 && layer < _variables.length() && indexInLayer >= 0 && indexInLayer < _variables[layer].length())
-			_variables[layer].removeAt(indexInLayer);
-
-	}
-	
-	for (int i = _variables.length() - 1; i >= 0; i--)
-	{
-		if (_variables[i].length() == 0)
-			_variables.removeAt(i);
-	}
-
-	_setTerms();
-	
-	endResetModel();	
+	_removeVariables(sortedIndexes);
+	_removeEmptyLayers();
+	_updateLayerNames();
 }
 
 QVariant ListModelLayersAssigned::data(const QModelIndex &index, int role) const
@@ -28,6 +28,7 @@ public:
 	ListModelLayersAssigned(JASPListControl* listView);
 
 	QVariant	data(const QModelIndex &index, int role = Qt::DisplayRole)					const	override;
+	bool		rowsAreTerms()																const	override { return false; } // The layers have their own header rows
 	Terms		termsFromIndexes(const QList<int> &indexes)									const	override;
 	Terms		addTerms(const Terms& terms, int dropItemIndex = -1, const RowControlsValues& rowValues = RowControlsValues())	override;
 	void		moveTerms(const QList<int>& indexes, int dropItemIndex = -1)						override;
@@ -39,8 +40,14 @@ public:
 private:
 	int			_getLayer(int index, int& realIndex, bool inclusive = false) const;
 	void		_setTerms();
+	void		_setLayerStarts();
+	void		_insertVariables(int layer, int indexInLayer, const QStringList& variables);
+	void		_removeVariables(const QList<int>& sortedIndexes);
+	void		_removeEmptyLayers();
+	void		_updateLayerNames();
 	
 	QList<QList<QString> >	_variables;
+	QVector<int>			_layerStarts;	///< Row of each layer, and of the virtual layer at the end: the layer of a row is found with a binary search
 };
 
 #endif // LISTMODELLAYERSASSIGNED_H
@@ -22,6 +22,8 @@
 #include "boundcontrols/boundcontrolmeasurescells.h"
 #include "log.h"
 
+#include <algorithm>
+
 using namespace std;
 
 
@@ -34,17 +36,12 @@ void ListModelMeasuresCellsAssigned::initLevels(const Terms &levels, const Terms
 {
 	beginResetModel();
 	_levels.clear();
-	vector<vector<string> > allLevels = levels.asVectorOfVectors();
 
-	for (const vector<string>& levels : allLevels)
-	{
-		string concatLevels;
-		if (levels.size() > 0)
-			concatLevels = levels[0];
-		for (uint i = 1; i < levels.size(); i++)
-			concatLevels += "," + levels[i];
-		_levels.push_back(QString::fromStdString(concatLevels));
-	}
+	for (const Term& cellLevels : levels)
+		_levels.push_back(_levelsLabel(cellLevels));
+
+	BoundControlMeasuresCells* boundControl = _measuresCellsBoundControl();
+	_levelsRevision = boundControl ? boundControl->levelsRevision() : -1;
 	
 	if (initVariables)
 		_setTerms(variables);
@@ -69,12 +66,22 @@ void ListModelMeasuresCellsAssigned::_fitTermsWithLevels()
 	}
 }
 
-void ListModelMeasuresCellsAssigned::sourceTermsReset()
+QString ListModelMeasuresCellsAssigned::_levelsLabel(const Term &levels)
+{
+	return levels.components().join(",");
+}
+
+BoundControlMeasuresCells* ListModelMeasuresCellsAssigned::_measuresCellsBoundControl() const
 {
 	VariablesListBase* measureCellsListView = dynamic_cast<VariablesListBase*>(listView());
-	if (measureCellsListView)
+	return measureCellsListView ? dynamic_cast<BoundControlMeasuresCells*>(measureCellsListView->boundControl()) : nullptr;
+}
+
+void ListModelMeasuresCellsAssigned::_resetLevels()
+{
+	BoundControlMeasuresCells* boundControl = _measuresCellsBoundControl();
+	if (boundControl)
 	{
-		BoundControlMeasuresCells* boundControl = dynamic_cast<BoundControlMeasuresCells*>(measureCellsListView->boundControl());
 		initLevels(boundControl->getLevels());
 		availableModel()->removeTermsInAssignedList();
 	}
@@ -82,6 +89,108 @@ void ListModelMeasuresCellsAssigned::sourceTermsReset()
 		Log::log() << "ListView from Measures cells model is not of a Measures Cell type!!";
 }
 
+void ListModelMeasuresCellsAssigned::sourceTermsReset()
+{
+	// The levels are already up to date if they were updated by updateLevels (or if only a factor name changed)
+	BoundControlMeasuresCells* boundControl = _measuresCellsBoundControl();
+	if (boundControl && boundControl->levelsRevision() == _levelsRevision)
+		return;
+
+	_resetLevels();
+}
+
+void ListModelMeasuresCellsAssigned::updateLevels(int offset, const QVector<int> &newCellIndexes, const QVector<int> &changedCells, const Terms &sourceLevels, int levelsRevision)
+{
+	int nbOldCells = int(newCellIndexes.length()),
+		nbNewCells = int(sourceLevels.size());
+
+	// The cells must be up to date with the previous revision, and the cells must keep their order: otherwise initialize them again.
+	bool canUpdate = levelsRevision == _levelsRevision + 1 && offset + nbOldCells <= _levels.length() && int(terms().size()) == _levels.length();
+
+	for (int cell = 0, lastNewCell = -1; cell < nbOldCells && canUpdate; cell++)
+		if (newCellIndexes[cell] >= 0)
+		{
+			canUpdate	= newCellIndexes[cell] > lastNewCell && newCellIndexes[cell] < nbNewCells;
+			lastNewCell	= newCellIndexes[cell];
+		}
+
+	if (!canUpdate)
+	{
+		_resetLevels();
+		return;
+	}
+
+	_levelsRevision = levelsRevision;
+
+	// Each cell has 2 rows: the variable and the levels
+	bool			variableRemoved = false;
+	vector<bool>	keptCells(size_t(nbNewCells), false);
+
+	for (int cell : newCellIndexes)
+		if (cell >= 0)
+			keptCells[size_t(cell)] = true;
+
+	if (nbOldCells != nbNewCells || std::find(newCellIndexes.begin(), newCellIndexes.end(), -1) != newCellIndexes.end())
+		clearSelectedItems();
+
+	for (int last = nbOldCells - 1; last >= 0; last--)
+	{
+		if (newCellIndexes[last] >= 0) continue;
+
+		int first = last;
+		while (first > 0 && newCellIndexes[first - 1] < 0) first--;
+
+		beginRemoveRows(QModelIndex(), 2 * (offset + first), 2 * (offset + last) + 1);
+		for (int cell = last; cell >= first; cell--)
+		{
+			variableRemoved = variableRemoved || !terms().at(size_t(offset + cell)).asQString().isEmpty();
+			_levels.removeAt(offset + cell);
+			_removeTerm(offset + cell);
+		}
+		endRemoveRows();
+
+		last = first;
+	}
+
+	for (int first = 0; first < nbNewCells; first++)
+	{
+		if (keptCells[size_t(first)]) continue;
+
+		int last = first;
+		while (last + 1 < nbNewCells && !keptCells[size_t(last + 1)]) last++;
+
+		Terms emptyCells;
+		for (int cell = first; cell <= last; cell++)
+			emptyCells.add(Term(QString()), false);
+
+		beginInsertRows(QModelIndex(), 2 * (offset + first), 2 * (offset + last) + 1);
+		for (int cell = first; cell <= last; cell++)
+			_levels.insert(offset + cell, _levelsLabel(sourceLevels.at(size_t(cell))));
+		_insertTerms(offset + first, emptyCells);
+		endInsertRows();
+
+		first = last;
+	}
+
+	for (int i = 0; i < changedCells.length(); i++)
+	{
+		int first = changedCells[i], last = first;
+		_levels[offset + first] = _levelsLabel(sourceLevels.at(size_t(first)));
+
+		while (i + 1 < changedCells.length() && changedCells[i + 1] == last + 1)
+		{
+			last = changedCells[++i];
+			_levels[offset + last] = _levelsLabel(sourceLevels.at(size_t(last)));
+		}
+
+		emit dataChanged(index(2 * (offset + first) + 1, 0), index(2 * (offset + last) + 1, 0));
+	}
+
+	// The variables of the removed cells go back to the available list
+	if (variableRemoved && availableModel() != nullptr)
+		availableModel()->removeTermsInAssignedList();
+}
+
 Terms ListModelMeasuresCellsAssigned::termsFromIndexes(const QList<int> &indexes) const
 {
 	Terms result;
@@ -207,7 +316,7 @@ QVariant ListModelMeasuresCellsAssigned::data(const QModelIndex &index, int role
 	}
 	else if (role == ListModel::SelectedRole)
 	{
-		if (_selectedItems.contains(indexRow) && realCol == 0)
+		if (_selection.contains(indexRow) && realCol == 0)
 			return true;
 		else
 			return false;
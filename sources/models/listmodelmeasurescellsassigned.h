@@ -22,6 +22,7 @@
 #include "listmodelassignedinterface.h"
 
 class ListModelFactorLevels;
+class BoundControlMeasuresCells;
 
 class ListModelMeasuresCellsAssigned : public ListModelAssignedInterface
 {
@@ -31,6 +32,7 @@ public:
 
 	int				rowCount(const QModelIndex &parent = QModelIndex())												const	override { return _levels.size() * 2; }
 	QVariant		data(const QModelIndex &index, int role = Qt::DisplayRole)										const	override;
+	bool			rowsAreTerms()																					const	override { return false; } // A term and its level take 2 rows
 	Terms			termsFromIndexes(const QList<int> &indexes)														const	override;
 	void			initTerms(const Terms &terms, const RowControlsValues& allValuesMap = RowControlsValues(), bool reInit = false)		override;
 	Terms			addTerms(const Terms& termsToAdd, int dropItemIndex = -1, const RowControlsValues& rowValues = RowControlsValues()) override;
@@ -38,14 +40,19 @@ public:
 	void			removeTerms(const QList<int>& indexes) override;
 
 	void			initLevels(const Terms& levels, const Terms &variables = Terms(), bool initVariables = false);
+	void			updateLevels(int offset, const QVector<int>& newCellIndexes, const QVector<int>& changedCells, const Terms& sourceLevels, int levelsRevision);
 
 public slots:	
 	void			sourceTermsReset()																					override;
 	
 private:
-	void			_fitTermsWithLevels();
+	void						_fitTermsWithLevels();
+	void						_resetLevels();
+	BoundControlMeasuresCells*	_measuresCellsBoundControl()	const;
+	static QString				_levelsLabel(const Term& levels);
 
-	QList<QString> _levels;
+	QList<QString>	_levels;
+	int				_levelsRevision = -1;		///< Revision of the levels of the factors models when _levels was set
 };
 
 #endif // LISTMODELMEASURESCELLSASSIGNED_H
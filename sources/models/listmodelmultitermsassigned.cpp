@@ -20,6 +20,8 @@
 #include "controls/jasplistcontrol.h"
 #include "log.h"
 
+#include <QSet>
+
 
 using namespace std;
 
@@ -31,6 +33,145 @@ ListModelMultiTermsAssigned::ListModelMultiTermsAssigned(JASPListControl* listVi
 	_allowDuplicatesInMultipleColumns = listView->property("allowDuplicatesInMultipleColumns").toBool();
 }
 
+int ListModelMultiTermsAssigned::_termId(const QString &term)
+{
+	if (term.isEmpty()) return 0;
+
+	auto itr = _termIds.find(term);
+	if (itr != _termIds.end())
+		return itr.value();
+
+	_termNames.append(term);
+	return _termIds[term] = int(_termNames.length()) - 1;
+}
+
+int ListModelMultiTermsAssigned::_knownTermId(const QString &term) const
+{
+	if (term.isEmpty()) return 0;
+
+	return _termIds.value(term, -1);
+}
+
+void ListModelMultiTermsAssigned::_compactTermIds()
+{
+	// Only the terms that are still in a tuple keep an id
+	QStringList			termNames = { QString() };
+	QHash<QString, int>	termIds;
+
+	for (int& id : _cells)
+		if (id != 0)
+		{
+			const QString& term = _termNames[id];
+
+			auto itr = termIds.find(term);
+			if (itr == termIds.end())
+			{
+				termNames.append(term);
+				itr = termIds.insert(term, int(termNames.length()) - 1);
+			}
+			id = itr.value();
+		}
+
+	_termNames.swap(termNames);
+	_termIds.swap(termIds);
+}
+
+bool ListModelMultiTermsAssigned::_tupleContains(int row, int termId) const
+{
+	for (int col = 0; col < _columns; col++)
+		if (_cell(row, col) == termId)
+			return true;
+
+	return false;
+}
+
+bool ListModelMultiTermsAssigned::_tupleIsEmpty(int row) const
+{
+	return std::all_of(_cells.begin() + row * _columns, _cells.begin() + (row + 1) * _columns, [](int id) { return id == 0; });
+}
+
+void ListModelMultiTermsAssigned::_setCell(int row, int col, int termId)
+{
+	int index = row * _columns + col;
+	if (_cells[size_t(index)] == termId) return;
+
+	_cells[size_t(index)] = termId;
+	_replaceTerm(index, Term(_termNames[termId]));
+
+	// The changed cells are signalled together by _emitCellsChanged
+	if (_changedFirst < 0 || index < _changedFirst)	_changedFirst	= index;
+	if (index > _changedLast)						_changedLast	= index;
+}
+
+void ListModelMultiTermsAssigned::_emitCellsChanged()
+{
+	if (_changedFirst < 0) return;
+
+	int first = _changedFirst,
+		last  = _changedLast;
+
+	_changedFirst = _changedLast = -1;
+
+	emit dataChanged(index(first, 0), index(last, 0));
+}
+
+void ListModelMultiTermsAssigned::_appendTuples(const std::vector<int> &cells)
+{
+	if (cells.empty()) return;
+
+	_emitCellsChanged();
+
+	int first = int(_cells.size());
+
+	Terms newTerms;
+	for (int id : cells)
+		newTerms.add(Term(_termNames[id]), false);
+
+	beginInsertRows(QModelIndex(), first, first + int(cells.size()) - 1);
+	_cells.insert(_cells.end(), cells.begin(), cells.end());
+	_insertTerms(first, newTerms);
+	endInsertRows();
+}
+
+void ListModelMultiTermsAssigned::_removeTuples(int row, int count)
+{
+	_emitCellsChanged();
+
+	int first	= row * _columns,
+		nbCells	= count * _columns;
+
+	beginRemoveRows(QModelIndex(), first, first + nbCells - 1);
+	_cells.erase(_cells.begin() + first, _cells.begin() + first + nbCells);
+	_removeTerms(first, nbCells);
+	endRemoveRows();
+}
+
+void ListModelMultiTermsAssigned::initTuples(const std::vector<std::vector<std::string> > &tuples)
+{
+	// Single values are set as terms: they are put together into tuples
+	if (tuples.empty() || tuples[0].size() <= 1)
+	{
+		initTerms(Terms(tuples));
+		return;
+	}
+
+	beginResetModel();
+
+	_cells.clear();
+	_cells.reserve(tuples.size() * size_t(_columns));
+	_termNames = { QString() };
+	_termIds.clear();
+
+	for (const std::vector<std::string>& tuple : tuples)
+		for (int col = 0; col < _columns; col++)
+			_cells.push_back(size_t(col) < tuple.size() ? _termId(tq(tuple[size_t(col)])) : 0);
+
+	_setTerms();
+
+	_rowControlsValues.clear();
+	endResetModel();
+}
+
 void ListModelMultiTermsAssigned::initTerms(const Terms &terms, const RowControlsValues& allValuesMap, bool)
 {
 	beginResetModel();
@@ -40,57 +181,60 @@ void ListModelMultiTermsAssigned::initTerms(const Terms &terms, const RowControl
 	{
 		if (terms[0].components().size() > 1)
 		{
-			_tuples.clear();
+			_cells.clear();
 
 			for (const Term& term : terms)
-			{
-				Terms row;
-
-				for (const QString& comp : term.components())
-					row.add(comp, false);
-				_tuples.push_back(row);
-			}
+				for (int col = 0; col < _columns; col++)
+					_cells.push_back(col < term.components().length() ? _termId(term.components()[col]) : 0);
 		}
 		else
 		{
 			// In this case discard elements in tuples that are not in terms.
 			// And then add the terms that were not in the tuples
-			QList<Terms> newTuples;
-			for (int i = 0; i < _tuples.size(); i++)
+			std::vector<int>	termIds;
+			QSet<int>			wantedIds,
+								usedIds;
+
+			for (const Term& term : terms)
 			{
-				Terms row = _tuples[i];
-				row.discardWhatIsntTheseTerms(terms);
-				if (row.size() > 0)
-				{
-					for (int j = int(row.size()); j < _columns; j++)
-						row.add(QString(), false);
-					newTuples.push_back(row);
-				}
+				termIds.push_back(_termId(term.asQString()));
+				wantedIds.insert(termIds.back());
 			}
 
-			_tuples = newTuples;
-			Terms unusedTerms = terms;
-
-			for (const Terms& tuple : _tuples)
-				unusedTerms.discardWhatDoesContainTheseTerms(tuple);
-
-			size_t index = 0;
-			while (unusedTerms.size() > index)
+			std::vector<int> newCells;
+			for (int row = 0; row < tupleCount(); row++)
 			{
-				Terms row;
-				for (int i = 0; i < _columns; i++)
+				std::vector<int> tuple;
+				for (int col = 0; col < _columns; col++)
 				{
-					if (unusedTerms.size() > index)
-						row.add(unusedTerms.at(index), false);
-					else
-						row.add(QString(), false);
-					index++;
+					int id = _cell(row, col);
+					if (id == 0 || wantedIds.contains(id))
+					{
+						tuple.push_back(id);
+						usedIds.insert(id);
+					}
+				}
+
+				if (tuple.size() > 0)
+				{
+					tuple.resize(size_t(_columns), 0);
+					newCells.insert(newCells.end(), tuple.begin(), tuple.end());
 				}
-				_tuples.push_back(row);
 			}
+
+			for (int id : termIds)
+				if (!usedIds.contains(id))
+				{
+					newCells.push_back(id);
+					usedIds.insert(id);
+				}
+
+			newCells.resize((newCells.size() + size_t(_columns) - 1) / size_t(_columns) * size_t(_columns), 0);
+			_cells.swap(newCells);
 		}
 	}
 
+	_compactTermIds();
 	_setTerms();
 
 	_rowControlsValues = allValuesMap;
@@ -101,39 +245,34 @@ void ListModelMultiTermsAssigned::initTerms(const Terms &terms, const RowControl
 void ListModelMultiTermsAssigned::removeTerms(const QList<int> &indexes)
 {
 	if (indexes.length() == 0) return;
-	
-	beginResetModel();
 
-	QList<int> orderedIndexed = indexes;
-	std::sort(orderedIndexed.begin(), orderedIndexed.end(), std::greater<int>());
+	// First empty the cells: a tuple whose cells are all empty is removed
+	std::vector<bool> removeTuple(size_t(tupleCount()), false);
 
-	for (const int &orderedIndexed: orderedIndexed)
+	for (int index : indexes)
 	{
-		int row = orderedIndexed / _columns;
-		int col = orderedIndexed % _columns;
-		
-		if (row < _tuples.length())
+		int row = index / _columns;
+		int col = index % _columns;
+
+		if (index >= 0 && row < tupleCount())
 		{
-			const Terms& terms = _tuples.at(row);
-			bool isEmpty = true;
-			for (int i = 0; i < _columns; i++)
-			{
-				if (i != col && !terms.at(size_t(i)).asQString().isEmpty())
-					isEmpty = false;
-			}
-			if (isEmpty)
-				_tuples.removeAt(row);
-			else
-			{
-				Terms newTerms = terms;
-				newTerms.replace(col, QString());
-				_tuples[row] = newTerms;
-			}
+			_setCell(row, col, 0);
+			removeTuple[size_t(row)] = _tupleIsEmpty(row);
 		}
 	}
 
-	_setTerms();
-	endResetModel();
+	_emitCellsChanged();
+
+	// Then remove the empty tuples, one run of consecutive tuples at a time (from the last one so that the rows of the other runs do not change)
+	for (int row = tupleCount() - 1; row >= 0; row--)
+		if (removeTuple[size_t(row)])
+		{
+			int last = row;
+			while (row > 0 && removeTuple[size_t(row - 1)])
+				row--;
+
+			_removeTuples(row, last - row + 1);
+		}
 }
 
 void ListModelMultiTermsAssigned::availableTermsResetHandler(Terms , Terms termsToRemove)
@@ -153,11 +292,8 @@ void ListModelMultiTermsAssigned::availableTermsResetHandler(Terms , Terms terms
 void ListModelMultiTermsAssigned::_setTerms()
 {
 	Terms newTerms;
-	for (const Terms& terms : _tuples)
-	{
-		for (const Term& term : terms)
-			newTerms.add(term, false);
-	}
+	for (int id : _cells)
+		newTerms.add(Term(_termNames[id]), false);
 
 	ListModel::_setTerms(newTerms);
 }
@@ -165,7 +301,6 @@ void ListModelMultiTermsAssigned::_setTerms()
 
 Terms ListModelMultiTermsAssigned::addTerms(const Terms& termsToAdd, int dropItemIndex, const RowControlsValues&)
 {
-	beginResetModel();
 	Terms termsToReturn;
 	
 	if (termsToAdd.size() == 0)
@@ -180,20 +315,18 @@ Terms ListModelMultiTermsAssigned::addTerms(const Terms& termsToAdd, int dropIte
 		// . It there was already a term at that place, return it.
 		int realRow = dropItemIndex / _columns;
 		int realCol = dropItemIndex % _columns;
-		if (realRow < _tuples.size())
+		if (realRow < tupleCount())
 		{
-			Terms row = _tuples[realRow];
-			const Term& termToAdd = termsToAdd.at(0);
+			const Term& termToAdd	= termsToAdd.at(0);
+			int			knownId		= _knownTermId(termToAdd.asQString()); // A term is given an id only when it is really added
 
-			if (row.contains(termToAdd) && !_allowDuplicatesInMultipleColumns)
+			if (knownId >= 0 && _tupleContains(realRow, knownId) && !_allowDuplicatesInMultipleColumns)
 				termsToReturn.add(termToAdd);
 			else
 			{
-				const Term& term = row[size_t(realCol)];
-				if (!term.asQString().isEmpty())
-					termsToReturn.add(term);
-				row.replace(realCol, termToAdd);
-				_tuples[realRow] = row;
+				if (_cell(realRow, realCol) != 0)
+					termsToReturn.add(Term(tupleValue(realRow, realCol)));
+				_setCell(realRow, realCol, _termId(termToAdd.asQString()));
 			}
 			done = true;
 		}
@@ -203,49 +336,33 @@ Terms ListModelMultiTermsAssigned::addTerms(const Terms& termsToAdd, int dropIte
 	{
 		// First try to set the terms to the empty places
 		size_t index = 0;
-		for (int row = 0; row < _tuples.length() && index < termsToAdd.size(); row++)
+		for (int row = 0; row < tupleCount() && index < termsToAdd.size(); row++)
 		{
-			Terms tuple = _tuples.at(row);
-			bool changed = false;
 			for (int col = 0; col < _columns && index < termsToAdd.size(); col++)
 			{
-				if (tuple[size_t(col)].asQString().isEmpty())
+				if (_cell(row, col) == 0)
 				{
-					const Term& termToAdd = termsToAdd.at(index);
-					if (tuple.contains(termToAdd) && !_allowDuplicatesInMultipleColumns)
+					const QString&	termToAdd	= termsToAdd.at(index).asQString();
+					int				knownId		= _knownTermId(termToAdd);
+					if (knownId >= 0 && _tupleContains(row, knownId) && !_allowDuplicatesInMultipleColumns)
 						termsToReturn.add(termsToAdd);
 					else
-					{
-						tuple.replace(col, termsToAdd.at(index));
-						changed = true;
-					}
+						_setCell(row, col, _termId(termToAdd));
 					index++;
 				}
 			}
-			if (changed)
-				_tuples[row] = tuple;
 		}
 		
 		// If there still some terms to add, add them at the end of the list
-		while (index < termsToAdd.size())
-		{
-			Terms newTuple;
-			for (int i = 0; i < _columns; i++)
-			{
-				if (index < termsToAdd.size())
-				{
-					newTuple.add(termsToAdd.at(index), false);
-					index++;
-				}
-				else
-					newTuple.add(QString(), false);
-			}
-			_tuples.push_back(newTuple);
-		}
+		std::vector<int> newCells;
+		for (; index < termsToAdd.size(); index++)
+			newCells.push_back(_termId(termsToAdd.at(index).asQString()));
+
+		newCells.resize((newCells.size() + size_t(_columns) - 1) / size_t(_columns) * size_t(_columns), 0);
+		_appendTuples(newCells);
 	}
-	
-	_setTerms();
-	endResetModel();
+
+	_emitCellsChanged();
 
 	return termsToReturn;
 }
@@ -262,56 +379,47 @@ void ListModelMultiTermsAssigned::moveTerms(const QList<int> &indexes, int dropI
 	int fromRow = fromIndex / _columns;
 	int fromCol = fromIndex % _columns;
 
-	if (fromRow >= _tuples.size())
+	if (fromRow >= tupleCount())
 		return;
 
-	Terms fromTuple = _tuples[fromRow];
-	Terms dropTuple;
 	int dropRow = -1;
 	bool addNewRow = false;
-	Term fromValue = fromTuple[size_t(fromCol)];
+	int fromValue = _cell(fromRow, fromCol);
 
-	if (fromValue.asQString().isEmpty())
+	if (fromValue == 0)
 		return;
 
-	beginResetModel();
-
 	if (dropItemIndex >= 0)
 	{
 		// First handle the case when the term is dropped on one particular place
 		dropRow = dropItemIndex / _columns;
 		int dropCol = dropItemIndex % _columns;
 
-		if (dropRow < _tuples.size())
+		if (dropRow < tupleCount())
 		{
-			dropTuple = _tuples[dropRow];
-			Term dropValue = dropTuple[size_t(dropCol)];
+			int dropValue = _cell(dropRow, dropCol);
 
 			if (dropRow == fromRow)
 			{
 				if (fromCol != dropCol)
 				{
-					dropTuple.replace(dropCol, fromValue);
-					dropTuple.replace(fromCol, dropValue);
-					_tuples[dropRow] = dropTuple;
+					_setCell(dropRow, dropCol, fromValue);
+					_setCell(fromRow, fromCol, dropValue);
 				}
 			}
 			else
 			{
 				// If it does not allow duplicates, and the dropTuple contains the fromValue or the fromTuple contains the dropValue (if not empty), then do not exchange the values.
-				if (!(!_allowDuplicatesInMultipleColumns && (dropTuple.contains(fromValue) || (!dropValue.asQString().isEmpty() && fromTuple.contains(dropValue)))))
+				if (!(!_allowDuplicatesInMultipleColumns && (_tupleContains(dropRow, fromValue) || (dropValue != 0 && _tupleContains(fromRow, dropValue)))))
 				{
-					dropTuple.replace(dropCol, fromValue);
-					fromTuple.replace(fromCol, dropValue);
-					_tuples[dropRow] = dropTuple;
-					_tuples[fromRow] = fromTuple;
+					_setCell(dropRow, dropCol, fromValue);
+					_setCell(fromRow, fromCol, dropValue);
 				}
 			}
 		}
 		else
 		{
-			fromTuple.replace(fromCol, QString());
-			_tuples[fromRow] = fromTuple;
+			_setCell(fromRow, fromCol, 0);
 			addNewRow = true;
 		}
 	}
@@ -319,22 +427,19 @@ void ListModelMultiTermsAssigned::moveTerms(const QList<int> &indexes, int dropI
 	{
 		// The term is dropped at the end of the list.
 		// Check whether the last row has still some place
-		fromTuple.replace(fromCol, QString());
-		_tuples[fromRow] = fromTuple;
+		_setCell(fromRow, fromCol, 0);
 
-		dropRow = _tuples.size() - 1;
-		dropTuple = _tuples[dropRow];
+		dropRow = tupleCount() - 1;
 		addNewRow = true;
 
 		// It it does not allow duplicates, and the last row contains the fromValue, then do not try to add the fromValue to the last row
-		if (!(!_allowDuplicatesInMultipleColumns && dropTuple.contains(fromValue)))
+		if (!(!_allowDuplicatesInMultipleColumns && _tupleContains(dropRow, fromValue)))
 		{
 			for (int i = 0; i < _columns && !addNewRow; i++)
 			{
-				if (dropTuple[size_t(i)].asQString().isEmpty())
+				if (_cell(dropRow, i) == 0)
 				{
-					dropTuple.replace(i, fromValue);
-					_tuples[dropRow] = dropTuple;
+					_setCell(dropRow, i, fromValue);
 					addNewRow = false;
 				}
 			}
@@ -343,22 +448,13 @@ void ListModelMultiTermsAssigned::moveTerms(const QList<int> &indexes, int dropI
 
 	if (addNewRow)
 	{
-		Terms newRow;
-		newRow.add(fromValue);
-		for (int i = 1; i < _columns; i++)
-			newRow.add(QString(), false);
-		_tuples.push_back(newRow);
+		std::vector<int> newRow(size_t(_columns), 0);
+		newRow[0] = fromValue;
+		_appendTuples(newRow);
 	}
 
-	bool removeFromTuple = true;
-	for (int i = 0; i < _columns; i++)
-	{
-		if (!fromTuple[size_t(i)].asQString().isEmpty())
-			removeFromTuple = false;
-	}
-	if (removeFromTuple)
-		_tuples.removeAt(fromRow);
+	if (_tupleIsEmpty(fromRow))
+		_removeTuples(fromRow, 1);
 
-	_setTerms();
-	endResetModel();
+	_emitCellsChanged();
 }
@@ -21,6 +21,8 @@
 
 #include "listmodelassignedinterface.h"
 
+#include <QHash>
+
 class ListModelMultiTermsAssigned: public ListModelAssignedInterface
 {
 	Q_OBJECT
@@ -32,18 +34,37 @@ public:
 	void			moveTerms(const QList<int>& indexes, int dropItemIndex = -1)									override;
 	void			removeTerms(const QList<int> &indexes)															override;
 
-	const QList<Terms>&	tuples() const { return _tuples; }
+	void			initTuples(const std::vector<std::vector<std::string> >& tuples);
+
+	int				columns()									const	{ return _columns;								}
+	int				tupleCount()								const	{ return int(_cells.size()) / _columns;			}
+	const QString&	tupleValue(int row, int col)				const	{ return _termNames[_cell(row, col)];			}
 
 public slots:
 	void			availableTermsResetHandler(Terms termsToAdd, Terms termsToRemove)							override;
 
 private:
 	void			_setTerms();
+	int				_termId(const QString& term);
+	int				_knownTermId(const QString& term)			const;
+	void			_compactTermIds();
+	int				_cell(int row, int col)						const	{ return _cells[size_t(row * _columns + col)];	}
+	bool			_tupleContains(int row, int termId)			const;
+	bool			_tupleIsEmpty(int row)						const;
+	void			_setCell(int row, int col, int termId);
+	void			_emitCellsChanged();
+	void			_appendTuples(const std::vector<int>& cells);
+	void			_removeTuples(int row, int count);
 
 protected:
-	int				_columns = 2;
-	QList<Terms>	_tuples;
-	bool			_allowDuplicatesInMultipleColumns = false;
+	int					_columns = 2;
+	///The tuples, one after the other, as ids of their terms: a tuple has always _columns cells, and the id of an empty cell is 0.
+	std::vector<int>	_cells;
+	QStringList			_termNames = { QString() };
+	QHash<QString, int>	_termIds;
+	int					_changedFirst	= -1,	///< Range of the cells changed by _setCell, not yet signalled
+						_changedLast	= -1;
+	bool				_allowDuplicatesInMultipleColumns = false;
 };
 
 #endif // LISTMODELMULTITERMSASSIGNED_H
@@ -0,0 +1,154 @@
+//
+// Copyright (C) 2013-2018 University of Amsterdam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as
+// published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public
+// License along with this program.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include "rowselection.h"
+
+bool RowSelection::contains(int row) const
+{
+	if (row < 0 || size_t(row / _bits) >= _words.size())
+		return false;
+
+	return (_words[size_t(row / _bits)] >> (row % _bits)) & 1;
+}
+
+int RowSelection::first() const
+{
+	for (size_t w = 0; w < _words.size(); w++)
+		if (_words[w])
+			for (int b = 0; b < _bits; b++)
+				if ((_words[w] >> b) & 1)
+					return int(w) * _bits + b;
+
+	return -1;
+}
+
+QList<int> RowSelection::rows() const
+{
+	QList<int> result;
+	result.reserve(_count);
+
+	for (size_t w = 0; w < _words.size(); w++)
+		if (_words[w])
+			for (int b = 0; b < _bits; b++)
+				if ((_words[w] >> b) & 1)
+					result.append(int(w) * _bits + b);
+
+	return result;
+}
+
+void RowSelection::_reserve(int row)
+{
+	size_t nbWords = size_t(row / _bits) + 1;
+	if (_words.size() < nbWords)
+		_words.resize(nbWords, 0);
+}
+
+bool RowSelection::_setBit(int row, bool select)
+{
+	if (row < 0 || contains(row) == select)
+		return false;
+
+	_reserve(row);
+
+	uint64_t mask = uint64_t(1) << (row % _bits);
+	if (select)
+	{
+		_words[size_t(row / _bits)] |= mask;
+		_count++;
+	}
+	else
+	{
+		_words[size_t(row / _bits)] &= ~mask;
+		_count--;
+	}
+
+	return true;
+}
+
+void RowSelection::_addToRanges(Ranges &ranges, int row)
+{
+	if (ranges.size() > 0 && ranges.back().second == row - 1)
+		ranges.back().second = row;
+	else
+		ranges.push_back({row, row});
+}
+
+RowSelection::Ranges RowSelection::set(int row, bool select)
+{
+	Ranges ranges;
+	if (_setBit(row, select))
+		ranges.push_back({row, row});
+
+	return ranges;
+}
+
+RowSelection::Ranges RowSelection::setRange(int first, int last, bool select, std::function<bool(int)> isSelectable)
+{
+	Ranges ranges;
+	if (first < 0)
+		first = 0;
+
+	for (int row = first; row <= last; row++)
+		if ((!select || !isSelectable || isSelectable(row)) && _setBit(row, select))
+			_addToRanges(ranges, row);
+
+	return ranges;
+}
+
+RowSelection::Ranges RowSelection::invert(int first, int last, std::function<bool(int)> isSelectable)
+{
+	Ranges ranges;
+	if (first < 0)
+		first = 0;
+
+	for (int row = first; row <= last; row++)
+	{
+		bool select = !contains(row);
+		if ((!select || !isSelectable || isSelectable(row)) && _setBit(row, select))
+			_addToRanges(ranges, row);
+	}
+
+	return ranges;
+}
+
+RowSelection::Ranges RowSelection::selectMatching(int nbRows, std::function<bool(int)> predicate)
+{
+	Ranges ranges;
+
+	for (int row = 0; row < nbRows; row++)
+		if (predicate(row) && _setBit(row, true))
+			_addToRanges(ranges, row);
+
+	return ranges;
+}
+
+RowSelection::Ranges RowSelection::clear()
+{
+	Ranges ranges;
+
+	for (size_t w = 0; w < _words.size(); w++)
+		if (_words[w])
+			for (int b = 0; b < _bits; b++)
+				if ((_words[w] >> b) & 1)
+					_addToRanges(ranges, int(w) * _bits + b);
+
+	_words.clear();
+	_count = 0;
+
+	return ranges;
+}
@@ -0,0 +1,62 @@
+//
+// Copyright (C) 2013-2018 University of Amsterdam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as
+// published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public
+// License along with this program.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#ifndef ROWSELECTION_H
+#define ROWSELECTION_H
+
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include <QList>
+
+///
+/// Selected rows of a ListModel, stored as a bitset.
+/// Checking whether a row is selected and getting the number of selected rows is O(1).
+/// The operations changing the selection return the contiguous ranges of rows that were really changed,
+/// so that the model can emit one dataChanged signal per range instead of one per row.
+///
+class RowSelection
+{
+public:
+	typedef std::pair<int, int>			Range; // first & last row, inclusive
+	typedef std::vector<Range>			Ranges;
+
+	bool				contains(int row)																	const;
+	int					count()																				const	{ return _count; }
+	bool				isEmpty()																			const	{ return _count == 0; }
+	int					first()																				const;
+	QList<int>			rows()																				const;
+
+	Ranges				set(int row, bool select);
+	Ranges				setRange(int first, int last, bool select, std::function<bool(int)> isSelectable = nullptr);
+	Ranges				invert(int first, int last, std::function<bool(int)> isSelectable = nullptr);
+	Ranges				selectMatching(int nbRows, std::function<bool(int)> predicate);
+	Ranges				clear();
+
+private:
+	static const int	_bits = 64;
+
+	void				_reserve(int row);
+	bool				_setBit(int row, bool select);
+	static void			_addToRanges(Ranges& ranges, int row);
+
+	std::vector<uint64_t>	_words;
+	int						_count = 0;
+};
+
+#endif // ROWSELECTION_H
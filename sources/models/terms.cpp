@@ -541,13 +541,10 @@ void Terms::remove(const Terms &terms)
 
 void Terms::remove(size_t pos, size_t n)
 {
-	vector<Term>::iterator itr = _terms.begin();
+	if (pos >= _terms.size())
+		return;
 
-	for (size_t i = 0; i < pos && itr != _terms.end(); i++)
-		itr++;
-
-	for (; n > 0 && itr != _terms.end(); n--)
-		_terms.erase(itr);
+	_terms.erase(_terms.begin() + pos, _terms.begin() + pos + std::min(n, _terms.size() - pos));
 }
 
 void Terms::replace(int pos, const Term &term)
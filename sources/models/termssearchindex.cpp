@@ -0,0 +1,164 @@
+//
+// Copyright (C) 2013-2018 University of Amsterdam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as
+// published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public
+// License along with this program.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include "termssearchindex.h"
+#include "terms.h"
+
+#include <algorithm>
+
+void TermsSearchIndex::build(const Terms &terms)
+{
+	_sorted.clear();
+	_rowToKey.clear();
+	_sorted.reserve(terms.size());
+	_rowToKey.reserve(terms.size());
+
+	int row = 0;
+	for (const Term& term : terms)
+	{
+		QString key = fold(term.asQString());
+		_rowToKey.push_back(key);
+		_sorted.push_back({key, row++});
+	}
+
+	std::sort(_sorted.begin(), _sorted.end());
+	_valid = true;
+}
+
+void TermsSearchIndex::insertRows(const Terms &terms, int first, int last)
+{
+	if (!_valid)
+		return;
+
+	int count = last - first + 1;
+	if (first < 0 || count <= 0 || first > size() || size_t(last) >= terms.size() || size_t(size() + count) != terms.size())
+	{
+		invalidate();
+		return;
+	}
+
+	for (Entry& entry : _sorted)
+		if (entry.row >= first)
+			entry.row += count;
+
+	std::vector<Entry> added;
+	added.reserve(size_t(count));
+	for (int row = first; row <= last; row++)
+		added.push_back({fold(terms.at(size_t(row)).asQString()), row});
+
+	_rowToKey.insert(_rowToKey.begin() + first, size_t(count), QString());
+	for (const Entry& entry : added)
+		_rowToKey[size_t(entry.row)] = entry.key;
+
+	std::sort(added.begin(), added.end());
+	size_t middle = _sorted.size();
+	_sorted.insert(_sorted.end(), added.begin(), added.end());
+	std::inplace_merge(_sorted.begin(), _sorted.begin() + middle, _sorted.end());
+}
+
+void TermsSearchIndex::removeRows(int first, int last)
+{
+	if (!_valid)
+		return;
+
+	int count = last - first + 1;
+	if (first < 0 || count <= 0 || last >= size())
+	{
+		invalidate();
+		return;
+	}
+
+	_sorted.erase(std::remove_if(_sorted.begin(), _sorted.end(), [first, last](const Entry& entry) { return entry.row >= first && entry.row <= last; }), _sorted.end());
+
+	for (Entry& entry : _sorted)
+		if (entry.row > last)
+			entry.row -= count;
+
+	_rowToKey.erase(_rowToKey.begin() + first, _rowToKey.begin() + last + 1);
+}
+
+std::vector<TermsSearchIndex::Entry>::const_iterator TermsSearchIndex::_lowerBound(const QString &foldedSearch) const
+{
+	return std::lower_bound(_sorted.begin(), _sorted.end(), foldedSearch, [](const Entry& entry, const QString& search) { return entry.key < search; });
+}
+
+QList<int> TermsSearchIndex::search(const QString &searchString, SearchMode mode) const
+{
+	QList<int> result;
+	if (searchString.isEmpty())
+		return result;
+
+	QString search = fold(searchString);
+
+	switch (mode)
+	{
+	case SearchMode::Prefix:
+		for (auto it = _lowerBound(search); it != _sorted.end() && it->key.startsWith(search); ++it)
+			result.append(it->row);
+		std::sort(result.begin(), result.end());
+		break;
+
+	case SearchMode::Substring:
+		for (int row = 0; row < size(); row++)
+			if (_rowToKey[size_t(row)].contains(search))
+				result.append(row);
+		break;
+
+	case SearchMode::Fuzzy:
+		for (int row = 0; row < size(); row++)
+			if (fuzzyMatch(_rowToKey[size_t(row)], search))
+				result.append(row);
+		break;
+	}
+
+	return result;
+}
+
+int TermsSearchIndex::nextPrefixMatch(const QString &searchString, int startRow) const
+{
+	if (searchString.isEmpty())
+		return -1;
+
+	QString search		= fold(searchString);
+	int		firstRow	= -1,
+			nextRow		= -1;
+
+	for (auto it = _lowerBound(search); it != _sorted.end() && it->key.startsWith(search); ++it)
+	{
+		if (firstRow < 0 || it->row < firstRow)
+			firstRow = it->row;
+		if (it->row >= startRow && (nextRow < 0 || it->row < nextRow))
+			nextRow = it->row;
+	}
+
+	return nextRow >= 0 ? nextRow : firstRow;
+}
+
+bool TermsSearchIndex::fuzzyMatch(const QString &foldedKey, const QString &foldedSearch)
+{
+	int pos = 0;
+	for (const QChar& c : foldedSearch)
+	{
+		pos = foldedKey.indexOf(c, pos);
+		if (pos < 0)
+			return false;
+		pos++;
+	}
+
+	return true;
+}
@@ -0,0 +1,71 @@
+//
+// Copyright (C) 2013-2018 University of Amsterdam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as
+// published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public
+// License along with this program.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#ifndef TERMSSEARCHINDEX_H
+#define TERMSSEARCHINDEX_H
+
+#include <vector>
+#include <QString>
+#include <QList>
+
+class Terms;
+
+///
+/// Search index used by the type-ahead search of the VariablesList.
+/// It keeps the case-folded terms of a list model sorted, so that all terms starting with some string are found with a binary search (O(log n + k)).
+/// The index is updated incrementally when rows are inserted or removed, and completely rebuilt (lazily, at the next search) when the model is reset.
+/// Substring and fuzzy (all characters in the same order) searches are also possible: they cannot use the sort order, but still avoid to
+/// lower-case every term at each keystroke.
+///
+class TermsSearchIndex
+{
+public:
+	enum class SearchMode { Prefix = 0, Substring, Fuzzy };
+
+	void				invalidate()									{ _valid = false;	}
+	bool				isValid()								const	{ return _valid;	}
+	void				build(const Terms& terms);
+	void				insertRows(const Terms& terms, int first, int last);
+	void				removeRows(int first, int last);
+	int					size()									const	{ return int(_rowToKey.size()); }
+
+	///Returns the rows of the terms matching searchString, sorted by row.
+	QList<int>			search(const QString& searchString, SearchMode mode = SearchMode::Prefix)	const;
+	///Returns the first row, starting from startRow (and wrapping around), of a term starting with searchString, or -1
+	int					nextPrefixMatch(const QString& searchString, int startRow)					const;
+
+	static QString		fold(const QString& str)						{ return str.toCaseFolded(); }
+	static bool			fuzzyMatch(const QString& foldedKey, const QString& foldedSearch);
+
+private:
+	struct Entry
+	{
+		QString			key;
+		int				row;
+
+		bool operator<(const Entry& other) const { return key < other.key || (key == other.key && row < other.row); }
+	};
+
+	std::vector<Entry>::const_iterator	_lowerBound(const QString& foldedSearch)	const;
+
+	std::vector<Entry>		_sorted;
+	std::vector<QString>	_rowToKey;
+	bool					_valid = false;
+};
+
+#endif // TERMSSEARCHINDEX_H
@@ -0,0 +1,115 @@
+//
+// Copyright (C) 2013-2018 University of Amsterdam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as
+// published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public
+// License along with this program.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include "optionsdiff.h"
+
+Json::Value OptionsDiff::path(const std::string &name, const QVector<AnalysisBase::ParentKey> &parentKeys)
+{
+	Json::Value result(Json::arrayValue);
+
+	for (const AnalysisBase::ParentKey& parentKey : parentKeys)
+	{
+		Json::Value row(Json::objectValue),
+					keyValue(Json::arrayValue);
+
+		for (const std::string& component : parentKey.value)
+			keyValue.append(component);
+
+		row["name"]		= parentKey.name;
+		row["key"]		= parentKey.key;
+		row["value"]	= keyValue;
+
+		result.append(row);
+	}
+
+	result.append(name);
+
+	return result;
+}
+
+Json::Value *OptionsDiff::_findRow(Json::Value &rows, const std::string &key, const Json::Value &keyValue)
+{
+	if (!rows.isArray())
+		return nullptr;
+
+	// The key of a row is a string, or an array of strings for an interaction
+	for (Json::Value& row : rows)
+	{
+		if (!row.isObject() || !row.isMember(key))
+			continue;
+
+		const Json::Value& rowKey = row[key];
+		if (rowKey == keyValue || (rowKey.isString() && keyValue.size() == 1 && keyValue[0] == rowKey))
+			return &row;
+	}
+
+	return nullptr;
+}
+
+bool OptionsDiff::applyDiff(Json::Value &options, const Diff &diff)
+{
+	for (const Change& change : diff)
+	{
+		if (change.path.size() == 0)
+			return false;
+
+		Json::Value* parent = &options;
+		for (Json::ArrayIndex i = 0; i < change.path.size() - 1 && parent; i++)
+		{
+			const Json::Value& row = change.path[i];
+			parent = parent->isObject() ? _findRow((*parent)[row["name"].asString()], row["key"].asString(), row["value"]) : nullptr;
+		}
+
+		const std::string name = change.path[change.path.size() - 1].asString();
+
+		if (!parent || !(parent->isObject() || parent->isNull()))
+			return false;
+		else if (change.type == Change::Type::Removed)
+			parent->removeMember(name);
+		else
+			(*parent)[name] = change.newValue;
+	}
+
+	return true;
+}
+
+Json::Value OptionsDiff::diffToJson(const Diff &diff)
+{
+	Json::Value result(Json::arrayValue);
+
+	for (const Change& change : diff)
+	{
+		Json::Value jsonChange(Json::objectValue);
+
+		switch (change.type)
+		{
+		case Change::Type::Added:	jsonChange["type"] = "added";	break;
+		case Change::Type::Removed:	jsonChange["type"] = "removed";	break;
+		case Change::Type::Changed:	jsonChange["type"] = "changed";	break;
+		}
+
+		jsonChange["path"]		= change.path;
+		jsonChange["control"]	= change.controlName;
+		if (change.type != Change::Type::Added)		jsonChange["oldValue"] = change.oldValue;
+		if (change.type != Change::Type::Removed)	jsonChange["newValue"] = change.newValue;
+
+		result.append(jsonChange);
+	}
+
+	return result;
+}
@@ -0,0 +1,55 @@
+//
+// Copyright (C) 2013-2018 University of Amsterdam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as
+// published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public
+// License along with this program.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#ifndef OPTIONSDIFF_H
+#define OPTIONSDIFF_H
+
+#include <json/json.h>
+#include <string>
+#include <vector>
+#include "analysisbase.h"
+
+///
+/// Changes of the bound values of a form, one per control whose value was set.
+/// A control inside a row of a list control (for instance a ComponentsList) is identified by its name and by the parent keys of its row,
+/// so a diff can be applied to another copy of the options without knowing the position of the rows.
+///
+class OptionsDiff
+{
+public:
+	struct Change
+	{
+		enum class Type { Added, Removed, Changed };
+
+		Type							type;
+		std::string						controlName;	///< Name of the control that set the value
+		Json::Value						path,			///< For each parent list, an object with its name, its option key and the key value of the row, then the control name
+										oldValue,
+										newValue;
+	};
+	typedef std::vector<Change>			Diff;
+
+	static Json::Value					path(const std::string& name, const QVector<AnalysisBase::ParentKey>& parentKeys);
+	static bool							applyDiff(Json::Value& options, const Diff& diff);
+	static Json::Value					diffToJson(const Diff& diff);
+
+private:
+	static Json::Value				*	_findRow(Json::Value& rows, const std::string& key, const Json::Value& keyValue);
+};
+
+#endif // OPTIONSDIFF_H
@@ -278,7 +278,8 @@ void RSyntax::addFormula(Formula *formula)
 
 bool RSyntax::parseRSyntaxOptions(Json::Value &options) const
 {
-	Log::log() << "Parse Syntax Options: " << options.toStyledString() << std::endl;
+	// Don't log the whole options: they may be large, and this would serialize them once more.
+	Log::log() << "Parse Syntax Options: " << options.size() << " options" << std::endl;
 	if (!options.isObject())
 	{
 		addError("Wrong type of options!");
@@ -295,7 +296,7 @@ bool RSyntax::parseRSyntaxOptions(Json::Value &options) const
 			controlName = _rSyntaxToControlNameMap[syntaxName];
 			if (controlName != syntaxName)
 			{
-				options[fq(controlName)] = options[member];
+				options[fq(controlName)].swap(options[member]);
 				options.removeMember(member);
 			}
 		}
@@ -304,7 +305,7 @@ bool RSyntax::parseRSyntaxOptions(Json::Value &options) const
 		if (listControl)
 		{
 			BoundControl* boundControl = listControl->boundControl();
-			Json::Value defaultOption = boundControl != nullptr ? boundControl->defaultBoundValue() : Json::Value::null;
+			const Json::Value& defaultOption = boundControl != nullptr ? boundControl->defaultBoundValue() : Json::Value::null;
 			const Json::Value& option = options[fq(controlName)];
 
 			// For user-friendliness purpose, an option that should have a structure (list of strings, or list of lists of strings...),
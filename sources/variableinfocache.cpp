@@ -0,0 +1,106 @@
+//
+// Copyright (C) 2013-2018 University of Amsterdam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as
+// published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public
+// License along with this program.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include "variableinfocache.h"
+#include "models/terms.h"
+
+VariableInfoCache::VariableInfoCache(QObject* parent) : QObject(parent)
+{
+	VariableInfo* variableInfo = VariableInfo::info();
+	if (variableInfo)
+	{
+		connect(variableInfo,	&VariableInfo::columnTypeChanged,	this,	&VariableInfoCache::invalidate);
+		connect(variableInfo,	&VariableInfo::labelsChanged,		this,	[this](QString columnName)	{ invalidate(columnName);			});
+		connect(variableInfo,	&VariableInfo::labelsReordered,		this,	&VariableInfoCache::invalidate);
+		connect(variableInfo,	&VariableInfo::columnsChanged,		this,	&VariableInfoCache::invalidateNames);
+		connect(variableInfo,	&VariableInfo::namesChanged,		this,	[this](QMap<QString, QString> changedNames)
+		{
+			invalidateNames(changedNames.keys());
+			invalidateNames(changedNames.values());
+		});
+	}
+}
+
+void VariableInfoCache::invalidateNames(const QStringList &names)
+{
+	for (const QString& name : names)
+		_cache.remove(name);
+}
+
+VariableInfoCache::ColumnInfo VariableInfoCache::info(const QString &name, bool withLabels)
+{
+	auto it = _cache.find(name);
+	if (it == _cache.end())
+	{
+		ColumnInfo columnInfo;
+		columnInfo.type = columnType(requestInfo(VariableInfo::VariableType, name).toInt());
+
+		// A name that is not (yet) a column is not kept: it might become one without any signal for this name.
+		if (columnInfo.type == columnType::unknown)
+		{
+			if (withLabels)
+			{
+				columnInfo.labels		= requestInfo(VariableInfo::Labels, name).toStringList();
+				columnInfo.labelsKnown	= true;
+			}
+			return columnInfo;
+		}
+
+		it = _cache.insert(name, columnInfo);
+	}
+
+	if (withLabels && !it->labelsKnown)
+	{
+		it->labels		= requestInfo(VariableInfo::Labels, name).toStringList();
+		it->labelsKnown	= true;
+	}
+
+	return it.value();
+}
+
+columnType VariableInfoCache::type(const QString &name)
+{
+	return info(name).type;
+}
+
+QStringList VariableInfoCache::labels(const QString &name)
+{
+	return info(name, true).labels;
+}
+
+std::vector<columnType> VariableInfoCache::types(const QStringList &names)
+{
+	std::vector<columnType> result;
+	result.reserve(size_t(names.size()));
+
+	for (const QString& name : names)
+		result.push_back(type(name));
+
+	return result;
+}
+
+std::vector<columnType> VariableInfoCache::types(const Terms &terms)
+{
+	std::vector<columnType> result;
+	result.reserve(terms.size());
+
+	for (const Term& term : terms)
+		result.push_back(term.size() == 1 ? type(term.asQString()) : columnType::unknown);
+
+	return result;
+}
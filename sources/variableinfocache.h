@@ -0,0 +1,72 @@
+//
+// Copyright (C) 2013-2018 University of Amsterdam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as
+// published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public
+// License along with this program.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#ifndef VARIABLEINFOCACHE_H
+#define VARIABLEINFOCACHE_H
+
+#include <QObject>
+#include <QHash>
+#include <QStringList>
+#include <vector>
+
+#include "variableinfo.h"
+
+class Terms;
+
+///
+/// Cache of the column information (type, labels) requested by the controls of one form.
+/// Requesting this information through the VariableInfoProvider may need to lock the dataset in the host, and a form asks it very often for the same columns
+/// (when filtering, sorting or checking the terms of its lists). With this cache, the information of a whole list of terms is resolved in one call:
+/// only the columns not yet known are requested to the provider.
+/// The information of a column is invalidated when VariableInfo signals that its type, labels, name or data have changed.
+///
+class VariableInfoCache : public QObject, public VariableInfoConsumer
+{
+	Q_OBJECT
+
+public:
+	struct ColumnInfo
+	{
+		columnType		type			= columnType::unknown;
+		bool			labelsKnown		= false;
+		QStringList		labels;
+
+		bool			isOrdinal()		const	{ return type == columnType::ordinal;	}
+		int				labelsCount()	const	{ return int(labels.size());			}
+	};
+
+	VariableInfoCache(QObject* parent = nullptr);
+
+	columnType					type(const QString& name);
+	std::vector<columnType>		types(const QStringList& names);
+	std::vector<columnType>		types(const Terms& terms);			// Interaction terms get an unknown type
+	QStringList					labels(const QString& name);
+	int							labelsCount(const QString& name)		{ return int(labels(name).size()); }
+	bool						isOrdinal(const QString& name)			{ return type(name) == columnType::ordinal; }
+	ColumnInfo					info(const QString& name, bool withLabels = false);
+
+public slots:
+	void						invalidate(const QString& name)			{ _cache.remove(name); }
+	void						invalidateNames(const QStringList& names);
+	void						invalidateAll()							{ _cache.clear(); }
+
+private:
+	QHash<QString, ColumnInfo>	_cache;
+};
+
+#endif // VARIABLEINFOCACHE_H